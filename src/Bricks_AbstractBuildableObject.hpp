@@ -42,6 +42,8 @@
 #define Bricks_ABSTRACTBUILDABLEOBJECT_HPP
 
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "Bricks_AbstractBuilder.hpp"
 #include "Bricks_AbstractSerializableObject.hpp"
@@ -93,6 +95,33 @@ class AbstractBuildableObjectPolicy
 	UndefinedAbstractBuildableObjectPolicy<T>::notDefined();
 	return std::string("Not implemented");
     }
+
+    /*!
+     * \brief Optional. Return the builder integral key of the derived object
+     * type.
+     * \param object Get the key of this object. The object has an
+     * implementation.
+     * \return The integral key of the derived object type, equal to
+     * getIntegralKey(objectType(object)) from the builder. Derived classes
+     * can cache the key with AbstractBuildableObject::integralKey() so
+     * identifying an object does not build a string. Serializers look the
+     * key up by name if this function is not implemented.
+     *
+     * static int objectIntegralKey( const T& object );
+     */
+
+    /*!
+     * \brief Optional. Return whether an object shares its underlying
+     * implementation with other objects.
+     * \param object Check this object. The object has an implementation.
+     * \return True if a copy of the object holds the same implementation,
+     * for example if the reference count of the implementation is greater
+     * than one. Serializers only return objects that are not shared to the
+     * builder pool and drop replaced objects if this function is not
+     * implemented.
+     *
+     * static bool objectIsShared( const T& object );
+     */
     //@}
 
     //@{
@@ -108,6 +137,115 @@ class AbstractBuildableObjectPolicy
     //@}
 };
 
+//---------------------------------------------------------------------------//
+/*!
+  \class DerivedBuildableObjectPolicy
+  \brief Optional policy definition for naming a derived class without
+  constructing it.
+
+  Derived classes without a specialization of this policy are constructed
+  once at registration to get their name from
+  AbstractBuildableObjectPolicy::objectType(). Derived classes that are
+  expensive to construct can specialize this policy to give their name
+  statically.
+*/
+//---------------------------------------------------------------------------//
+template<class T>
+class DerivedBuildableObjectPolicy
+{
+  public:
+
+    //! Derived class type.
+    typedef T object_type;
+
+    /*!
+     * \brief Optional. Return a string indicating the derived object type.
+     * \return The same string as AbstractBuildableObjectPolicy::objectType()
+     * gives for objects of the derived class.
+     *
+     * static std::string objectType();
+     */
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasDerivedObjectType
+  \brief Compile time check for the optional objectType() function of a
+  derived buildable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class DBOP>
+class HasDerivedObjectType
+{
+  private:
+
+    template<class U>
+    static std::true_type check( decltype(U::objectType())* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<DBOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+// Get the name of a derived class of a base class. The derived class is only
+// constructed if it does not implement the DerivedBuildableObjectPolicy.
+template<class Base, class Derived>
+std::string derivedObjectType();
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasObjectIntegralKey
+  \brief Compile time check for the optional objectIntegralKey() function of
+  a buildable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ABOP>
+class HasObjectIntegralKey
+{
+  private:
+
+    template<class U>
+    static std::true_type check( 
+	decltype(U::objectIntegralKey(
+		     std::declval<typename U::object_type>()))* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ABOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasObjectIsShared
+  \brief Compile time check for the optional objectIsShared() function of a
+  buildable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ABOP>
+class HasObjectIsShared
+{
+  private:
+
+    template<class U>
+    static std::true_type check( 
+	decltype(U::objectIsShared(
+		     std::declval<typename U::object_type>()))* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ABOP>(0))::value;
+};
+
 //---------------------------------------------------------------------------//
 /*!
   \class AbstractBuildableObject
@@ -140,23 +278,48 @@ class AbstractBuildableObject
 
     /*!
      * \brief Set an abstract factory for a AbstractBuildableObject subclass.
-     * \param factory A factory for a AbstractBuildableObject subclass.
+     * \param factory A factory for a AbstractBuildableObject subclass. One
+     * object is created with the factory to get the name of the subclass.
      */
     static void setDerivedClassFactory(
 	const Teuchos::RCP<const Teuchos::AbstractFactory<Object> >& factory );
 
     /*!
      * \brief Set an abstract factory for a AbstractBuildableObject subclass
-     * that can be built with a Teuchos::AbstractFactoryStd.
+     * that can be built with a Teuchos::AbstractFactoryStd. Objects of the
+     * subclass can also be created in bulk with the builder. The subclass
+     * is named by its DerivedBuildableObjectPolicy if it implements
+     * objectType(). Otherwise one object of the subclass is constructed to
+     * get its name.
      */
     template<class DerivedObject>
     static void setDerivedClassFactory();
 
+    /*!
+     * \brief Set an abstract factory for a AbstractBuildableObject subclass
+     * that allocates its objects with an allocator policy.
+     * \param allocator An allocator policy for Teuchos::AbstractFactoryStd,
+     * such as an ArenaAllocator for the subclass. The factory keeps a copy of
+     * the allocator. The subclass must be named by its
+     * DerivedBuildableObjectPolicy.
+     */
+    template<class DerivedObject, class Allocator>
+    static void setDerivedClassFactory( const Allocator& allocator );
+
     /*!
      * \brief Get the abstract builder for AbstractBuildableObject subclasses.
      * \return The builder for AbstractBuildableObject subclasses.
      */
     static Teuchos::RCP<AbstractBuilder<Object> > getBuilder();
+
+    /*!
+     * \brief Get the integral key of a derived class. The key is looked up
+     * by name the first time and cached for the derived class. The derived
+     * class must be named by its DerivedBuildableObjectPolicy.
+     * \return The builder integral key of the derived class.
+     */
+    template<class DerivedObject>
+    static int integralKey();
     //@}
 
   private:
@@ -47,6 +47,36 @@
 
 namespace Bricks
 {
+//---------------------------------------------------------------------------//
+// Get the name of a derived class from its derived buildable object policy.
+template<class Base, class Derived>
+std::string derivedObjectType( std::true_type )
+{
+    return DerivedBuildableObjectPolicy<Derived>::objectType();
+}
+
+//---------------------------------------------------------------------------//
+// Get the name of a derived class from an object of the derived class. This
+// default constructs and destroys an object of the derived class, including
+// any implementation it allocates, on every call.
+template<class Base, class Derived>
+std::string derivedObjectType( std::false_type )
+{
+    return AbstractBuildableObjectPolicy<Base>::objectType( Derived() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the name of a derived class of a base class.
+template<class Base, class Derived>
+std::string derivedObjectType()
+{
+    return derivedObjectType<Base,Derived>( 
+	std::integral_constant<
+	    bool,
+	    HasDerivedObjectType<DerivedBuildableObjectPolicy<Derived> >::value
+	    >() );
+}
+
 //---------------------------------------------------------------------------//
 // Constructor.
 template<class Object>
@@ -85,9 +115,30 @@ template<class Object>
 template<class DerivedObject>
 void AbstractBuildableObject<Object>::setDerivedClassFactory()
 { 
+    b_builder->template setDerivedClassFactory<DerivedObject>(
+	derivedObjectType<Object,DerivedObject>() );
+}
+
+//---------------------------------------------------------------------------//
+// Set an abstract builder for AbstractBuildableObject subclasses that
+// allocates its objects with an allocator policy.
+template<class Object>
+template<class DerivedObject, class Allocator>
+void AbstractBuildableObject<Object>::setDerivedClassFactory( 
+    const Allocator& allocator )
+{ 
+    static_assert( 
+	HasDerivedObjectType<DerivedBuildableObjectPolicy<DerivedObject> >::value,
+	"Derived classes with an allocator must be named by their "
+	"DerivedBuildableObjectPolicy." );
+    typedef Teuchos::AbstractFactoryStd<
+	Object,DerivedObject,Teuchos::PostModNothing<DerivedObject>,Allocator>
+	Factory;
     Teuchos::RCP<const Teuchos::AbstractFactory<Object> > factory =
-	Teuchos::abstractFactoryStd<Object,DerivedObject>();
-    setDerivedClassFactory( factory );
+	Teuchos::rcp( new Factory(Teuchos::PostModNothing<DerivedObject>(),
+				  allocator) );
+    b_builder->setDerivedClassFactory( 
+	factory, derivedObjectType<Object,DerivedObject>() );
 }
 
 //---------------------------------------------------------------------------//
@@ -99,6 +150,22 @@ AbstractBuildableObject<Object>::getBuilder()
     return b_builder; 
 }
 
+//---------------------------------------------------------------------------//
+// Get the integral key of a derived class. Integral keys do not change once
+// registered so the key is cached after the first lookup.
+template<class Object>
+template<class DerivedObject>
+int AbstractBuildableObject<Object>::integralKey()
+{
+    static_assert( 
+	HasDerivedObjectType<DerivedBuildableObjectPolicy<DerivedObject> >::value,
+	"Integral keys by derived class need the derived class to be named by "
+	"its DerivedBuildableObjectPolicy." );
+    static const int integral_key = 
+	b_builder->getIntegralKey( derivedObjectType<Object,DerivedObject>() );
+    return integral_key;
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Bricks
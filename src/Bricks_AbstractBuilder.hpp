@@ -41,10 +41,13 @@
 #ifndef Bricks_ABSTRACTBUILDER_HPP
 #define Bricks_ABSTRACTBUILDER_HPP
 
+#include <string>
+#include <unordered_map>
+
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_ArrayRCP.hpp>
 #include <Teuchos_AbstractFactory.hpp>
 #include <Teuchos_Array.hpp>
-#include <Teuchos_StandardParameterEntryValidators.hpp>
 
 namespace Bricks
 {
@@ -52,11 +55,39 @@ namespace Bricks
 /*!
   \class AbstractBuilder
   \brief Builder for constructing derived classes of the base.
+
+  The integral key of each derived class is its registration order. Names
+  are mapped to integral keys with a hash table so lookups by name take
+  constant time. Callers on a hot path should look the integral key up once
+  and create objects by key.
+
+  Derived classes are registered first and the builder is then frozen.
+  Registrations are rejected once the builder is frozen, so the names, keys
+  and factories no longer change and looking up keys and creating objects
+  are safe from any number of threads without locks if the factories are.
+  Factories are not assumed to be thread safe. The caller declares them
+  thread safe when freezing the builder so that objects may be created
+  from several threads. The object pool is not thread safe.
+
+  Derived classes registered by type can also be created in bulk. The
+  objects are built in one contiguous slab and the returned base class
+  handles keep the slab alive until the last of them is released.
+
+  The builder can also keep a pool of objects for each derived class. Objects
+  released to the pool are handed out again by acquire() instead of building
+  new ones. Pooled objects are not reset by the builder. Users reset them in
+  place, for example by deserializing into them.
 */
 //---------------------------------------------------------------------------//
 template<class Base>
 class AbstractBuilder
 {
+  public:
+
+    //! Slab factory for creating objects of one derived class together.
+    typedef Teuchos::Array<Teuchos::RCP<Base> > 
+    (*SlabFactory)( const std::size_t num_objects );
+
   public:
 
     /*!
@@ -82,12 +113,52 @@ class AbstractBuilder
 	entity_factory,
 	const std::string& name );
 
+    /*!
+     * \brief Set a derived class with the builder by type. Objects of the
+     * derived class can be created in bulk with createMany().
+     * \param name A name for the factory. This should be equivalent to the
+     * entityType() field from the implementation.
+     */
+    template<class Derived>
+    void setDerivedClassFactory( const std::string& name );
+
+    /*!
+     * \brief Freeze the registrations. No derived classes can be set with
+     * the builder after it is frozen.
+     * \param thread_safe_factories Declare that every factory set with the
+     * builder can create objects from any number of threads at once.
+     */
+    void freeze( const bool thread_safe_factories = false );
+
+    /*!
+     * \brief Get whether the registrations are frozen.
+     */
+    bool isFrozen() const;
+
+    /*!
+     * \brief Get whether objects can be created from any number of threads
+     * at once. This holds only for frozen builders whose factories were
+     * declared thread safe.
+     */
+    bool threadSafeFactories() const;
+
     /*!
      * \brief Get the integral key for a string key.
-     * \param The name to get the key for.
+     * \param The name to get the key for. The name must be registered.
      * \return The integral key.
      */
-    int getIntegralKey( const std::string& name );
+    int getIntegralKey( const std::string& name ) const;
+
+    /*!
+     * \brief Get whether a derived class is set with the builder.
+     * \param name The name of the derived class.
+     */
+    bool hasDerivedClass( const std::string& name ) const;
+
+    /*!
+     * \brief Get the number of derived classes set with the builder.
+     */
+    int numDerivedClasses() const;
 
     /*!
      * \brief Create a new base class with the given derived class factory
@@ -96,7 +167,7 @@ class AbstractBuilder
      * this name.
      * \return The created base class object.
      */
-    Teuchos::RCP<Base> create( const std::string& name );
+    Teuchos::RCP<Base> create( const std::string& name ) const;
           
     /*!
      * \brief Create a new base class with the given derived class factory
@@ -105,12 +176,65 @@ class AbstractBuilder
      * this integral key.
      * \return The created base class object.
      */
-    Teuchos::RCP<Base> create( const int key );
+    Teuchos::RCP<Base> create( const int key ) const;
+
+    /*!
+     * \brief Create many new base classes with the given derived class
+     * factory integral key.
+     * \param key Create the base classes using the derived class factory
+     * with this integral key.
+     * \param num_objects The number of objects to create.
+     * \return The created base class objects. If the derived class was set
+     * by type they are in one contiguous slab, otherwise each is created
+     * separately.
+     */
+    Teuchos::Array<Teuchos::RCP<Base> > 
+    createMany( const int key, const std::size_t num_objects ) const;
+
+    /*!
+     * \brief Turn the object pool on or off. Turning the pool off empties
+     * it.
+     */
+    void setPooling( const bool pooling );
+
+    /*!
+     * \brief Get whether the object pool is on.
+     */
+    bool pooling() const;
+
+    /*!
+     * \brief Get an object of a derived class from the pool. If the pool for
+     * the derived class is empty, a new object is created.
+     * \param key The integral key of the derived class.
+     * \return An object of the derived class.
+     */
+    Teuchos::RCP<Base> acquire( const int key );
+
+    /*!
+     * \brief Return an object of a derived class to the pool.
+     * \param key The integral key of the derived class of the object.
+     * \param object The object to return to the pool. Nothing else should
+     * hold a reference to the object.
+     */
+    void release( const int key, const Teuchos::RCP<Base>& object );
+
+    /*!
+     * \brief Get the number of objects of a derived class in the pool.
+     * \param key The integral key of the derived class.
+     */
+    std::size_t poolSize( const int key ) const;
+
+    /*!
+     * \brief Empty the object pools of all derived classes.
+     */
+    void clearPool();
 
   private:
 
-    // Build the validator.
-    void buildValidator();
+    // Create a slab of objects of a derived class.
+    template<class Derived>
+    static Teuchos::Array<Teuchos::RCP<Base> > 
+    createSlab( const std::size_t num_objects );
 
   private:
 
@@ -118,12 +242,23 @@ class AbstractBuilder
     Teuchos::Array<Teuchos::RCP<const Teuchos::AbstractFactory<Base> > >
     d_factories;
 
-    // Names.
-    Teuchos::Array<std::string> d_names;
+    // Slab factories. Null for derived classes not set by type.
+    Teuchos::Array<SlabFactory> d_slab_factories;
+
+    // Integral keys indexed by name.
+    std::unordered_map<std::string,int> d_keys;
+
+    // Frozen registration flag.
+    bool d_frozen;
+
+    // Thread safe factories flag.
+    bool d_thread_safe_factories;
+
+    // Object pool flag.
+    bool d_pooling;
 
-    // Validator.
-    Teuchos::RCP<Teuchos::StringToIntegralParameterEntryValidator<int> >
-    d_validator;
+    // Object pools indexed by integral key.
+    Teuchos::Array<Teuchos::Array<Teuchos::RCP<Base> > > d_pools;
 };
 
 //---------------------------------------------------------------------------//
@@ -41,12 +41,21 @@
 #ifndef Bricks_ABSTRACTBUILDER_IMPL_HPP
 #define Bricks_ABSTRACTBUILDER_IMPL_HPP
 
+#include <utility>
+
+#include "Bricks_DBC.hpp"
+
+#include <Teuchos_AbstractFactoryStd.hpp>
+
 namespace Bricks
 {
 //---------------------------------------------------------------------------//
 // Constructor.
 template<class Base>
 AbstractBuilder<Base>::AbstractBuilder()
+    : d_frozen( false )
+    , d_thread_safe_factories( false )
+    , d_pooling( false )
 { /* ... */ }
 
 //---------------------------------------------------------------------------//
@@ -63,50 +72,199 @@ void AbstractBuilder<Base>::setDerivedClassFactory(
     entity_factory,
     const std::string& name )
 {
+    Bricks_INSIST( !d_frozen );
+    Bricks_REQUIRE( 0 == d_keys.count(name) );
+    d_keys.insert( std::make_pair(name, int(d_factories.size())) );
     d_factories.push_back( entity_factory );
-    d_names.push_back( name );
+    d_slab_factories.push_back( 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Set a derived class with the builder by type.
+template<class Base>
+template<class Derived>
+void AbstractBuilder<Base>::setDerivedClassFactory( const std::string& name )
+{
+    setDerivedClassFactory( Teuchos::abstractFactoryStd<Base,Derived>(), name );
+    d_slab_factories.back() = &AbstractBuilder<Base>::createSlab<Derived>;
+}
+
+//---------------------------------------------------------------------------//
+// Freeze the registrations.
+template<class Base>
+void AbstractBuilder<Base>::freeze( const bool thread_safe_factories )
+{
+    d_frozen = true;
+    d_thread_safe_factories = thread_safe_factories;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether the registrations are frozen.
+template<class Base>
+bool AbstractBuilder<Base>::isFrozen() const
+{
+    return d_frozen;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether objects can be created from any number of threads at once.
+template<class Base>
+bool AbstractBuilder<Base>::threadSafeFactories() const
+{
+    return d_thread_safe_factories;
 }
 
 //---------------------------------------------------------------------------//
 // Get the integral key for a string key.
 template<class Base>
-int AbstractBuilder<Base>::getIntegralKey( const std::string& name )
+int AbstractBuilder<Base>::getIntegralKey( const std::string& name ) const
+{
+    typename std::unordered_map<std::string,int>::const_iterator key =
+	d_keys.find( name );
+    Bricks_INSIST( key != d_keys.end() );
+    return key->second;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether a derived class is set with the builder.
+template<class Base>
+bool AbstractBuilder<Base>::hasDerivedClass( const std::string& name ) const
+{
+    return d_keys.end() != d_keys.find( name );
+}
+
+//---------------------------------------------------------------------------//
+// Get the number of derived classes set with the builder.
+template<class Base>
+int AbstractBuilder<Base>::numDerivedClasses() const
 {
-    buildValidator();
-    return d_validator->getIntegralValue( name );
+    return d_factories.size();
 }
 
 //---------------------------------------------------------------------------//
 // Create a new Abstract with the given name.
 template<class Base>
 Teuchos::RCP<Base>
-AbstractBuilder<Base>::create( const std::string& name )
+AbstractBuilder<Base>::create( const std::string& name ) const
 {
-    buildValidator();
-    int factory_index = d_validator->getIntegralValue( name );
-    return d_factories[ factory_index ]->create();
+    return d_factories[ getIntegralKey(name) ]->create();
 }
 //---------------------------------------------------------------------------//
 // Create a new Abstract with the given integral key.
 template<class Base>
 Teuchos::RCP<Base>
-AbstractBuilder<Base>::create( const int key )
+AbstractBuilder<Base>::create( const int key ) const
 {
     return d_factories[ key ]->create();
 }
 
 //---------------------------------------------------------------------------//
-// Build the validator.
+// Create many new Abstracts with the given integral key.
+template<class Base>
+Teuchos::Array<Teuchos::RCP<Base> >
+AbstractBuilder<Base>::createMany( const int key, 
+				   const std::size_t num_objects ) const
+{
+    Bricks_REQUIRE( key >= 0 && key < d_factories.size() );
+    if ( 0 != d_slab_factories[key] )
+    {
+	return d_slab_factories[key]( num_objects );
+    }
+
+    Teuchos::Array<Teuchos::RCP<Base> > objects( num_objects );
+    for ( std::size_t i = 0; i < num_objects; ++i )
+    {
+	objects[i] = create( key );
+    }
+    return objects;
+}
+
+//---------------------------------------------------------------------------//
+// Turn the object pool on or off.
+template<class Base>
+void AbstractBuilder<Base>::setPooling( const bool pooling )
+{
+    d_pooling = pooling;
+    if ( !d_pooling )
+    {
+	clearPool();
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Get whether the object pool is on.
+template<class Base>
+bool AbstractBuilder<Base>::pooling() const
+{
+    return d_pooling;
+}
+
+//---------------------------------------------------------------------------//
+// Get an object of a derived class from the pool.
+template<class Base>
+Teuchos::RCP<Base> AbstractBuilder<Base>::acquire( const int key )
+{
+    Bricks_REQUIRE( key >= 0 && key < d_factories.size() );
+    if ( key < d_pools.size() && !d_pools[key].empty() )
+    {
+	Teuchos::RCP<Base> object = d_pools[key].back();
+	d_pools[key].pop_back();
+	return object;
+    }
+    return create( key );
+}
+
+//---------------------------------------------------------------------------//
+// Return an object of a derived class to the pool.
+template<class Base>
+void AbstractBuilder<Base>::release( const int key, 
+				     const Teuchos::RCP<Base>& object )
+{
+    Bricks_REQUIRE( key >= 0 && key < d_factories.size() );
+    Bricks_REQUIRE( Teuchos::nonnull(object) );
+    if ( d_pooling )
+    {
+	if ( d_pools.size() < d_factories.size() )
+	{
+	    d_pools.resize( d_factories.size() );
+	}
+	d_pools[key].push_back( object );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Get the number of objects of a derived class in the pool.
+template<class Base>
+std::size_t AbstractBuilder<Base>::poolSize( const int key ) const
+{
+    Bricks_REQUIRE( key >= 0 );
+    return ( key < d_pools.size() ) ? d_pools[key].size() : 0;
+}
+
+//---------------------------------------------------------------------------//
+// Empty the object pools of all derived classes.
+template<class Base>
+void AbstractBuilder<Base>::clearPool()
+{
+    d_pools.clear();
+}
+
+//---------------------------------------------------------------------------//
+// Create a slab of objects of a derived class. Each handle points into the
+// slab and holds a reference to it.
 template<class Base>
-void AbstractBuilder<Base>::buildValidator()
+template<class Derived>
+Teuchos::Array<Teuchos::RCP<Base> > 
+AbstractBuilder<Base>::createSlab( const std::size_t num_objects )
 {
-    if ( Teuchos::is_null(d_validator) )
+    Teuchos::ArrayRCP<Derived> slab = Teuchos::arcp<Derived>( num_objects );
+    Teuchos::Array<Teuchos::RCP<Base> > objects( num_objects );
+    for ( std::size_t i = 0; i < num_objects; ++i )
     {
-	std::string default_name( "No Default Implementation" );
-	d_validator = Teuchos::rcp(
-	    new Teuchos::StringToIntegralParameterEntryValidator<int>(
-		d_names(), default_name) );
+	objects[i] = Teuchos::rcpWithEmbeddedObj( 
+	    static_cast<Base*>(&slab[i]), slab, false );
     }
+    return objects;
 }
 
 //---------------------------------------------------------------------------//
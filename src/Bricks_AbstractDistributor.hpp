@@ -0,0 +1,168 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractDistributor.hpp
+ * \author Stuart R. Slattery
+ * \brief Parallel distributor for abstract objects.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTDISTRIBUTOR_HPP
+#define Bricks_ABSTRACTDISTRIBUTOR_HPP
+
+#include "Bricks_AbstractSerializer.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class AbstractDistributor
+  \brief Parallel distributor for abstract objects.
+
+  The distributor moves abstract objects to the ranks given for them. The
+  objects for each destination rank are packed into one message with
+  AbstractSerializer in its current format. The ranks that will send to this
+  rank are not known ahead of time and are discovered with the non-blocking
+  consensus (NBX) algorithm of Hoefler et. al. The messages are sent with
+  synchronous non-blocking sends and every rank probes for incoming messages
+  and unpacks them as they arrive. Once all of its sends have been matched a
+  rank enters a non-blocking barrier and the exchange is over when the
+  barrier completes. No communication of size P is needed.
+
+  The imported objects are ordered by source rank and then by their order on
+  the source rank so the result does not depend on the order in which the
+  messages arrive. Communicators that are not MPI communicators may only send
+  objects to their own rank.
+*/
+//---------------------------------------------------------------------------//
+template<class T>
+class AbstractDistributor
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef T                                   object_type;
+    typedef AbstractSerializer<int,T>           Serializer;
+    typedef Teuchos::Comm<int>                  CommType;
+    typedef Teuchos::RCP<const CommType>        RCP_Comm;
+    //@}
+
+    // Constructor.
+    explicit AbstractDistributor( const RCP_Comm& comm, const int tag = 3571 );
+
+    // Destructor.
+    ~AbstractDistributor();
+
+    // Distribute objects to their destination ranks.
+    void distribute( const Teuchos::ArrayView<const T>& exports,
+		     const Teuchos::ArrayView<const int>& destinations,
+		     Teuchos::Array<T>& imports );
+
+    //! Get the ranks objects were sent to in the last distribution.
+    Teuchos::ArrayView<const int> exportRanks() const
+    { return d_export_ranks(); }
+
+    //! Get the number of objects sent to each export rank.
+    Teuchos::ArrayView<const int> exportCounts() const
+    { return d_export_counts(); }
+
+    //! Get the ranks objects were received from in the last distribution.
+    Teuchos::ArrayView<const int> importRanks() const
+    { return d_import_ranks(); }
+
+    //! Get the number of objects received from each import rank.
+    Teuchos::ArrayView<const int> importCounts() const
+    { return d_import_counts(); }
+
+  private:
+
+    // Exchange the packed messages with the other ranks.
+    void exchange( const Teuchos::Array<char>& send_buffer,
+		   const Teuchos::Array<int>& send_offsets );
+
+    // Unpack a message from a source rank.
+    void unpack( const int source, 
+		 const Teuchos::ArrayView<const char>& message );
+
+  private:
+
+    // Communicator.
+    RCP_Comm d_comm;
+
+    // Message tag.
+    int d_tag;
+
+    // Number of distributions. Consecutive distributions use different tags
+    // so a message for the next distribution is never received early.
+    int d_num_distributions;
+
+    // Export ranks.
+    Teuchos::Array<int> d_export_ranks;
+
+    // Number of objects sent to each export rank.
+    Teuchos::Array<int> d_export_counts;
+
+    // Import ranks.
+    Teuchos::Array<int> d_import_ranks;
+
+    // Number of objects received from each import rank.
+    Teuchos::Array<int> d_import_counts;
+
+    // Objects received from each import rank in order of arrival.
+    Teuchos::Array<Teuchos::Array<T> > d_received;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_AbstractDistributor_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTDISTRIBUTOR_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractDistributor.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,285 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractDistributor_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Parallel distributor for abstract objects.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTDISTRIBUTOR_IMPL_HPP
+#define Bricks_ABSTRACTDISTRIBUTOR_IMPL_HPP
+
+#include <algorithm>
+#include <utility>
+
+#include "Bricks_DBC.hpp"
+
+#include <Teuchos_ConfigDefs.hpp>
+
+#ifdef HAVE_MPI
+#include <mpi.h>
+#include <Teuchos_DefaultMpiComm.hpp>
+#endif
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Constructor.
+template<class T>
+AbstractDistributor<T>::AbstractDistributor( const RCP_Comm& comm,
+					     const int tag )
+    : d_comm( comm )
+    , d_tag( tag )
+    , d_num_distributions( 0 )
+{
+    Bricks_REQUIRE( Teuchos::nonnull(d_comm) );
+}
+
+//---------------------------------------------------------------------------//
+// Destructor.
+template<class T>
+AbstractDistributor<T>::~AbstractDistributor()
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Distribute objects to their destination ranks. The imported objects are
+// ordered by source rank.
+template<class T>
+void AbstractDistributor<T>::distribute( 
+    const Teuchos::ArrayView<const T>& exports,
+    const Teuchos::ArrayView<const int>& destinations,
+    Teuchos::Array<T>& imports )
+{
+    Bricks_REQUIRE( exports.size() == destinations.size() );
+    int comm_size = d_comm->getSize();
+
+    // Group the exports by destination rank with a counting sort.
+    Teuchos::Array<int> dest_offsets( comm_size + 1, 0 );
+    for ( int i = 0; i < destinations.size(); ++i )
+    {
+	Bricks_REQUIRE( destinations[i] >= 0 && destinations[i] < comm_size );
+	++dest_offsets[ destinations[i] + 1 ];
+    }
+    for ( int r = 0; r < comm_size; ++r )
+    {
+	dest_offsets[r+1] += dest_offsets[r];
+    }
+    Teuchos::Array<T> sorted_exports( exports.size() );
+    Teuchos::Array<int> dest_pos( dest_offsets.begin(), dest_offsets.end()-1 );
+    for ( int i = 0; i < exports.size(); ++i )
+    {
+	sorted_exports[ dest_pos[destinations[i]]++ ] = exports[i];
+    }
+
+    // Pack the exports for each destination rank into one send buffer.
+    d_export_ranks.clear();
+    d_export_counts.clear();
+    Teuchos::Array<int> send_offsets( 1, 0 );
+    for ( int r = 0; r < comm_size; ++r )
+    {
+	int count = dest_offsets[r+1] - dest_offsets[r];
+	if ( count > 0 )
+	{
+	    d_export_ranks.push_back( r );
+	    d_export_counts.push_back( count );
+	    send_offsets.push_back( 
+		send_offsets.back() +
+		Serializer::fromCountToPackedBytes( 
+		    count, &sorted_exports[dest_offsets[r]] ) );
+	}
+    }
+    Teuchos::Array<char> send_buffer( send_offsets.back() );
+    for ( int n = 0; n < d_export_ranks.size(); ++n )
+    {
+	Serializer::serializePacked( 
+	    d_export_counts[n], 
+	    &sorted_exports[dest_offsets[d_export_ranks[n]]],
+	    send_offsets[n+1] - send_offsets[n],
+	    &send_buffer[send_offsets[n]] );
+    }
+
+    // Exchange the messages.
+    d_import_ranks.clear();
+    d_import_counts.clear();
+    d_received.clear();
+    exchange( send_buffer, send_offsets );
+    ++d_num_distributions;
+
+    // Order the imports by source rank. Each rank sends at most one
+    // message.
+    Teuchos::Array<std::pair<int,int> > order( d_import_ranks.size() );
+    for ( int n = 0; n < order.size(); ++n )
+    {
+	order[n] = std::make_pair( d_import_ranks[n], n );
+    }
+    std::sort( order.begin(), order.end() );
+
+    Teuchos::Array<int> import_ranks( order.size() );
+    Teuchos::Array<int> import_counts( order.size() );
+    imports.clear();
+    for ( int n = 0; n < order.size(); ++n )
+    {
+	import_ranks[n] = order[n].first;
+	import_counts[n] = d_import_counts[ order[n].second ];
+	imports.insert( imports.end(), 
+			d_received[ order[n].second ].begin(),
+			d_received[ order[n].second ].end() );
+    }
+    d_import_ranks.swap( import_ranks );
+    d_import_counts.swap( import_counts );
+    d_received.clear();
+}
+
+//---------------------------------------------------------------------------//
+// Exchange the packed messages with the other ranks. Messages to this rank
+// are unpacked directly.
+template<class T>
+void AbstractDistributor<T>::exchange( 
+    const Teuchos::Array<char>& send_buffer,
+    const Teuchos::Array<int>& send_offsets )
+{
+    int my_rank = d_comm->getRank();
+
+#ifdef HAVE_MPI
+    Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm =
+	Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >( d_comm );
+    if ( Teuchos::nonnull(mpi_comm) )
+    {
+	MPI_Comm raw_comm = (*mpi_comm->getRawMpiComm())();
+	int tag = d_tag + d_num_distributions % 2;
+
+	// Post a synchronous send for every message to another rank. A
+	// synchronous send completes only when it has been matched by a
+	// receive.
+	Teuchos::Array<MPI_Request> send_requests;
+	for ( int n = 0; n < d_export_ranks.size(); ++n )
+	{
+	    if ( d_export_ranks[n] != my_rank )
+	    {
+		send_requests.push_back( MPI_REQUEST_NULL );
+		MPI_Issend( const_cast<char*>(&send_buffer[send_offsets[n]]),
+			    send_offsets[n+1] - send_offsets[n],
+			    MPI_CHAR,
+			    d_export_ranks[n],
+			    tag,
+			    raw_comm,
+			    &send_requests.back() );
+	    }
+	}
+
+	// Unpack the message to this rank while the sends progress.
+	for ( int n = 0; n < d_export_ranks.size(); ++n )
+	{
+	    if ( d_export_ranks[n] == my_rank )
+	    {
+		unpack( my_rank, send_buffer(send_offsets[n], 
+					     send_offsets[n+1]-send_offsets[n]) );
+	    }
+	}
+
+	// Receive and unpack messages until all sends have been matched on
+	// every rank.
+	Teuchos::Array<char> receive_buffer;
+	MPI_Request barrier_request = MPI_REQUEST_NULL;
+	bool barrier_active = false;
+	int done = 0;
+	int found = 0;
+	int sent = 0;
+	int bytes = 0;
+	MPI_Status status;
+	while ( !done )
+	{
+	    MPI_Iprobe( MPI_ANY_SOURCE, tag, raw_comm, &found, &status );
+	    if ( found )
+	    {
+		MPI_Get_count( &status, MPI_CHAR, &bytes );
+		receive_buffer.resize( bytes );
+		MPI_Recv( receive_buffer.getRawPtr(), bytes, MPI_CHAR,
+			  status.MPI_SOURCE, tag, raw_comm, MPI_STATUS_IGNORE );
+		unpack( status.MPI_SOURCE, receive_buffer() );
+	    }
+
+	    if ( barrier_active )
+	    {
+		MPI_Test( &barrier_request, &done, MPI_STATUS_IGNORE );
+	    }
+	    else
+	    {
+		MPI_Testall( send_requests.size(), send_requests.getRawPtr(),
+			     &sent, MPI_STATUSES_IGNORE );
+		if ( sent )
+		{
+		    MPI_Ibarrier( raw_comm, &barrier_request );
+		    barrier_active = true;
+		}
+	    }
+	}
+	return;
+    }
+#endif
+
+    // Without MPI objects can only be sent to this rank.
+    for ( int n = 0; n < d_export_ranks.size(); ++n )
+    {
+	Bricks_REQUIRE( d_export_ranks[n] == my_rank );
+	unpack( my_rank, send_buffer(send_offsets[n], 
+				     send_offsets[n+1]-send_offsets[n]) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Unpack a message from a source rank.
+template<class T>
+void AbstractDistributor<T>::unpack( 
+    const int source, const Teuchos::ArrayView<const char>& message )
+{
+    int count = Serializer::fromPackedBytesToCount( 
+	message.size(), message.getRawPtr() );
+    d_import_ranks.push_back( source );
+    d_import_counts.push_back( count );
+    d_received.push_back( Teuchos::Array<T>(count) );
+    Serializer::deserializePacked( message.size(), message.getRawPtr(),
+				   count, d_received.back().getRawPtr() );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+#endif // end Bricks_ABSTRACTDISTRIBUTOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractDistributor_impl.hpp
+//---------------------------------------------------------------------------//
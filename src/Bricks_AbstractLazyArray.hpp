@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractLazyArray.hpp
+ * \author Stuart R. Slattery
+ * \brief Lazy array of abstract objects over a serialized buffer.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTLAZYARRAY_HPP
+#define Bricks_ABSTRACTLAZYARRAY_HPP
+
+#include "Bricks_AbstractSerializer.hpp"
+
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayRCP.hpp>
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class AbstractLazyArray
+  \brief Lazy array of abstract objects over a serialized buffer.
+
+  The array is constructed over an indirect char buffer from
+  AbstractSerializer in the wire format. The layout of the records is read
+  from the header of the buffer at construction, so the array does not
+  depend on later changes to the format setting. Only the integral keys of
+  the records are read at construction. A record is deserialized into an object
+  the first time the object is accessed and the object is then kept, so
+  records that are never accessed are never deserialized. The array holds a
+  reference to the buffer.
+*/
+//---------------------------------------------------------------------------//
+template<class T>
+class AbstractLazyArray
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef T                                   object_type;
+    typedef AbstractSerializer<int,T>           Serializer;
+    //@}
+
+    // Constructor.
+    explicit AbstractLazyArray( const Teuchos::ArrayRCP<const char>& buffer );
+
+    // Destructor.
+    ~AbstractLazyArray();
+
+    //! Get the number of objects in the array.
+    int size() const
+    { return d_keys.size(); }
+
+    //! Get the integral key of an object. Objects without an implementation
+    //! have a negative key.
+    int integralKey( const int i ) const
+    { return d_keys[i]; }
+
+    //! Check if an object has been deserialized.
+    bool isDeserialized( const int i ) const
+    { return d_deserialized[i]; }
+
+    // Get an object. The object is deserialized on the first access.
+    T& operator[]( const int i );
+
+  private:
+
+    // Serialized buffer.
+    Teuchos::ArrayRCP<const char> d_buffer;
+
+    // Layout of the records in the buffer.
+    typename Serializer::Format d_format;
+
+    // Integral keys of the records.
+    Teuchos::Array<int> d_keys;
+
+    // Offsets of the record data in the buffer.
+    Teuchos::Array<std::size_t> d_offsets;
+
+    // Objects.
+    Teuchos::Array<T> d_objects;
+
+    // Deserialized flags.
+    Teuchos::Array<char> d_deserialized;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_AbstractLazyArray_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTLAZYARRAY_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractLazyArray.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractLazyArray_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Lazy array of abstract objects over a serialized buffer.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTLAZYARRAY_IMPL_HPP
+#define Bricks_ABSTRACTLAZYARRAY_IMPL_HPP
+
+#include "Bricks_DBC.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Constructor. Index the records in the buffer.
+template<class T>
+AbstractLazyArray<T>::AbstractLazyArray( 
+    const Teuchos::ArrayRCP<const char>& buffer )
+    : d_buffer( buffer )
+    , d_format( Serializer::packedFormat(buffer.getRawPtr()) )
+{
+    int count = Serializer::fromPackedBytesToCount( 
+	d_buffer.size(), d_buffer.getRawPtr() );
+    Serializer::indexRecords( d_buffer.size(), d_buffer.getRawPtr(), count,
+			      d_keys, d_offsets );
+    d_objects.resize( count );
+    d_deserialized.resize( count, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Destructor.
+template<class T>
+AbstractLazyArray<T>::~AbstractLazyArray()
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Get an object. The object is deserialized on the first access.
+template<class T>
+T& AbstractLazyArray<T>::operator[]( const int i )
+{
+    Bricks_REQUIRE( i >= 0 && i < size() );
+    if ( !d_deserialized[i] )
+    {
+	Serializer::deserializeRecord( d_format, d_keys[i], 
+				       d_buffer.getRawPtr() + d_offsets[i], 
+				       d_objects[i] );
+	d_deserialized[i] = 1;
+    }
+    return d_objects[i];
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+#endif // end Bricks_ABSTRACTLAZYARRAY_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractLazyArray_impl.hpp
+//---------------------------------------------------------------------------//
@@ -41,7 +41,15 @@
 #ifndef Bricks_ABSTRACTOBJECTREGISTRY_HPP
 #define Bricks_ABSTRACTOBJECTREGISTRY_HPP
 
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "Bricks_AbstractBuildableObject.hpp"
+#include "Bricks_AbstractSerializableObject.hpp"
+
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 
 namespace Bricks
 {
@@ -81,7 +89,6 @@ class AbstractObjectRegistrationPolicy
     static void registerDerivedClassWithBaseClass()
     {
 	UndefinedAbstractObjectRegistrationPolicy<Derived>::notDefined();
-	return Teuchos::null;
     }
 };
 
@@ -96,6 +103,78 @@ class AbstractObjectRegistrationPolicy<void>
     { /* ... */ }
 };
 
+//---------------------------------------------------------------------------//
+/*!
+  \class RegistryTypeIndex
+  \brief Compile time index of a type in a list of types.
+*/
+//---------------------------------------------------------------------------//
+template<class T, class... List>
+struct RegistryTypeIndex;
+
+template<class T, class... List>
+struct RegistryTypeIndex<T,T,List...> 
+    : public std::integral_constant<int,0>
+{ /* ... */ };
+
+template<class T, class U, class... List>
+struct RegistryTypeIndex<T,U,List...> 
+    : public std::integral_constant<int,1+RegistryTypeIndex<T,List...>::value>
+{ /* ... */ };
+
+//---------------------------------------------------------------------------//
+/*!
+  \class RegistryTypeAt
+  \brief Compile time type at a position in a list of types. void if the
+  position is past the end of the list.
+*/
+//---------------------------------------------------------------------------//
+template<int N, class... List>
+struct RegistryTypeAt
+{
+    typedef void type;
+};
+
+template<class T, class... List>
+struct RegistryTypeAt<0,T,List...>
+{
+    typedef T type;
+};
+
+template<int N, class T, class... List>
+struct RegistryTypeAt<N,T,List...>
+{
+    typedef typename RegistryTypeAt<N-1,List...>::type type;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class RegistryByteSize
+  \brief Compile time maximum byte size of a list of derived classes.
+*/
+//---------------------------------------------------------------------------//
+template<class... List>
+struct RegistryByteSize;
+
+template<>
+struct RegistryByteSize<>
+{
+    static constexpr std::size_t maxByteSize()
+    { return 0; }
+};
+
+template<class T, class... List>
+struct RegistryByteSize<T,List...>
+{
+    static constexpr std::size_t maxByteSize()
+    { 
+	return ( DerivedSerializableObjectPolicy<T>::byteSize() > 
+		 RegistryByteSize<List...>::maxByteSize() )
+	    ? DerivedSerializableObjectPolicy<T>::byteSize()
+	    : RegistryByteSize<List...>::maxByteSize();
+    }
+};
+
 //---------------------------------------------------------------------------//
 /*!
   \class AbstractObjectRegistry
@@ -105,33 +184,82 @@ class AbstractObjectRegistrationPolicy<void>
   This class lets the user indicate which derived types will be used with a
   given base class. Derived classes must be registered with base classes
   inheriting from abstract compile time interfaces before use.
+
+  Any number of derived classes may be given and the list of derived types is
+  kept at compile time. The registry generates flat tables of functions over
+  the list, indexed by the position of each derived class in the list, for
+  creating objects, naming derived classes and getting their byte size. Every
+  derived class in the list must be named by the static objectType() of its
+  DerivedBuildableObjectPolicy so no object is constructed to name it.
+  Registration sets the derived classes with the base class builder in the
+  order of the list. The position of a derived class in the list need not be
+  its builder integral key, as other derived classes may have been
+  registered with the builder first. Registration fills a table from the
+  integral keys of the builder to the positions in the list which
+  position() looks up. mapIntegralKeys() fills the table when the derived
+  classes were registered with the builder some other way.
+
+  A serializable object policy that names the registry as its registry_type
+  lets serializers create objects and size records through these tables
+  instead of the builder factories. Integral keys without a position, such
+  as those of derived classes outside of the list or of a registry whose
+  table was never filled, fall back to the builder factories and the
+  serializable object policy. Objects are created by assigning a
+  default constructed derived class to a base class object, so the derived
+  classes must be default constructible and assignable to the base class.
+
+  The registry has no tables for serializing and deserializing objects.
+  Objects are serialized through the serializable object policy of the base
+  class, as a base class object holds its derived class behind a handle that
+  the tables could not reach without a cast per object.
+
+  If DerivedSerializableObjectPolicy::byteSize() is constexpr for every
+  derived class, the byte size of each derived class and the maximum byte
+  size of the list are compile time constants. They do not depend on the
+  order of registration and can size static buffers.
 */
 //---------------------------------------------------------------------------//
-template<class Base, 
-	 class Derived1 = void, 
-	 class Derived2 = void, 
-	 class Derived3 = void,
-	 class Derived4 = void, 
-	 class Derived5 = void, 
-	 class Derived6 = void,
-	 class Derived7 = void, 
-	 class Derived8 = void, 
-	 class Derived9 = void>
+template<class Base, class... Derived>
 class AbstractObjectRegistry
 {
   public:
 
     //! Typedefs.
-    typedef Base     base_type;
-    typedef Derived1 derived_type_1;
-    typedef Derived1 derived_type_2;
-    typedef Derived1 derived_type_3;
-    typedef Derived1 derived_type_4;
-    typedef Derived1 derived_type_5;
-    typedef Derived1 derived_type_6;
-    typedef Derived1 derived_type_7;
-    typedef Derived1 derived_type_8;
-    typedef Derived1 derived_type_9;
+    typedef Base base_type;
+
+    //! Function table entry for creating an object of a derived class.
+    typedef void (*CreateFunction)( Base& object );
+
+    //! Function table entry for naming a derived class.
+    typedef std::string (*ObjectTypeFunction)();
+
+    //! Function table entry for the byte size of a derived class.
+    typedef std::size_t (*ByteSizeFunction)();
+
+    //! Derived class at a position in the list.
+    template<int N>
+    struct derived_type
+    {
+	typedef typename std::tuple_element<N,std::tuple<Derived...> >::type 
+	type;
+    };
+
+    //@{
+    //! Deprecated. Derived classes at the positions 0 to 8 in the list or
+    //! void past the end of the list. Use derived_type instead.
+    typedef typename RegistryTypeAt<0,Derived...>::type derived_type_1;
+    typedef typename RegistryTypeAt<1,Derived...>::type derived_type_2;
+    typedef typename RegistryTypeAt<2,Derived...>::type derived_type_3;
+    typedef typename RegistryTypeAt<3,Derived...>::type derived_type_4;
+    typedef typename RegistryTypeAt<4,Derived...>::type derived_type_5;
+    typedef typename RegistryTypeAt<5,Derived...>::type derived_type_6;
+    typedef typename RegistryTypeAt<6,Derived...>::type derived_type_7;
+    typedef typename RegistryTypeAt<7,Derived...>::type derived_type_8;
+    typedef typename RegistryTypeAt<8,Derived...>::type derived_type_9;
+    //@}
+
+    //! Number of derived classes.
+    static const int num_derived_types = sizeof...(Derived);
 
     /*!
      * \brief Constructor.
@@ -146,10 +274,63 @@ class AbstractObjectRegistry
     { /* ... */ }
 
     /*!
-     * \brief Set an abstract factory for a AbstractObjectRegistry subclass.
-     * \param factory A factory for a AbstractObjectRegistry subclass.
+     * \brief Register the derived classes with the base class in the order
+     * of the list.
      */
     static void registerDerivedClasses();
+
+    // Map the builder integral keys of the derived classes to their
+    // positions in the list.
+    static void mapIntegralKeys();
+
+    // Get the position in the list of the derived class with a builder
+    // integral key. -1 if the integral key is not mapped.
+    static int position( const int integral_key );
+
+    /*!
+     * \brief Get the position of a derived class in the list.
+     */
+    template<class DerivedObject>
+    static constexpr int index()
+    { return RegistryTypeIndex<DerivedObject,Derived...>::value; }
+
+    // Make an object hold a new object of the derived class at a position
+    // in the list.
+    static void create( const int index, Base& object );
+
+    // Get the name of the derived class at a position in the list.
+    static std::string objectType( const int index );
+
+    // Get the byte size of the derived class at a position in the list.
+    static std::size_t byteSize( const int index );
+
+    /*!
+     * \brief Get the byte size of a derived class in the list.
+     */
+    template<class DerivedObject>
+    static constexpr std::size_t byteSize()
+    { return DerivedSerializableObjectPolicy<DerivedObject>::byteSize(); }
+
+    /*!
+     * \brief Get the maximum byte size of the derived classes in the list.
+     */
+    static constexpr std::size_t maxByteSize()
+    { return RegistryByteSize<Derived...>::maxByteSize(); }
+
+  private:
+
+    // Make an object hold a new object of a derived class.
+    template<class DerivedObject>
+    static void createDerived( Base& object );
+
+    // Get the name of a derived class.
+    template<class DerivedObject>
+    static std::string derivedObjectType();
+
+  private:
+
+    // Positions in the list indexed by builder integral key.
+    static Teuchos::Array<int> b_positions;
 };
 
 //---------------------------------------------------------------------------//
@@ -41,28 +41,118 @@
 #ifndef Bricks_ABSTRACTOBJECTREGISTRY_IMPL_HPP
 #define Bricks_ABSTRACTOBJECTREGISTRY_IMPL_HPP
 
+#include "Bricks_DBC.hpp"
+
 namespace Bricks
 {
 //---------------------------------------------------------------------------//
-template<class Base,
-	 class Derived1,class Derived2,class Derived3,
-	 class Derived4,class Derived5,class Derived6,
-	 class Derived7,class Derived8,class Derived9> 
-void
-AbstractObjectRegistry<Base,
-		      Derived1,Derived2,Derived3,
-		      Derived4,Derived5,Derived6,
-		      Derived7,Derived8,Derived9>::registerDerivedClasses()
+// Number of derived classes.
+template<class Base, class... Derived>
+const int AbstractObjectRegistry<Base,Derived...>::num_derived_types;
+
+//---------------------------------------------------------------------------//
+// Positions in the list indexed by builder integral key.
+template<class Base, class... Derived>
+Teuchos::Array<int> AbstractObjectRegistry<Base,Derived...>::b_positions;
+
+//---------------------------------------------------------------------------//
+// Register the derived classes with the base class in the order of the list.
+template<class Base, class... Derived>
+void AbstractObjectRegistry<Base,Derived...>::registerDerivedClasses()
+{
+    int expand[] = { 0, 
+		     (AbstractObjectRegistrationPolicy<
+		      Derived>::registerDerivedClassWithBaseClass(), 0)... };
+    (void) expand;
+    mapIntegralKeys();
+}
+
+//---------------------------------------------------------------------------//
+// Map the builder integral keys of the derived classes to their positions in
+// the list. Every derived class in the list must be registered with the base
+// class builder.
+template<class Base, class... Derived>
+void AbstractObjectRegistry<Base,Derived...>::mapIntegralKeys()
+{
+    Teuchos::RCP<AbstractBuilder<Base> > builder =
+	AbstractBuildableObjectPolicy<Base>::getBuilder();
+    b_positions.assign( builder->numDerivedClasses(), -1 );
+    for ( int i = 0; i < num_derived_types; ++i )
+    {
+	int integral_key = builder->getIntegralKey( objectType(i) );
+	Bricks_CHECK( integral_key < b_positions.size() );
+	b_positions[integral_key] = i;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Get the position in the list of the derived class with a builder integral
+// key. -1 if the integral key is not mapped.
+template<class Base, class... Derived>
+int AbstractObjectRegistry<Base,Derived...>::position( const int integral_key )
+{
+    Bricks_REQUIRE( integral_key >= 0 );
+    return ( integral_key < b_positions.size() ) 
+	? b_positions[integral_key] : -1;
+}
+
+//---------------------------------------------------------------------------//
+// Make an object hold a new object of the derived class at a position in the
+// list.
+template<class Base, class... Derived>
+void AbstractObjectRegistry<Base,Derived...>::create( const int index, 
+						      Base& object )
+{
+    static constexpr CreateFunction table[] = 
+	{ &AbstractObjectRegistry::template createDerived<Derived>... };
+    Bricks_REQUIRE( index >= 0 && index < num_derived_types );
+    table[index]( object );
+}
+
+//---------------------------------------------------------------------------//
+// Get the name of the derived class at a position in the list.
+template<class Base, class... Derived>
+std::string 
+AbstractObjectRegistry<Base,Derived...>::objectType( const int index )
+{
+    static constexpr ObjectTypeFunction table[] = 
+	{ &AbstractObjectRegistry::template derivedObjectType<Derived>... };
+    Bricks_REQUIRE( index >= 0 && index < num_derived_types );
+    return table[index]();
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the derived class at a position in the list.
+template<class Base, class... Derived>
+std::size_t 
+AbstractObjectRegistry<Base,Derived...>::byteSize( const int index )
+{
+    static constexpr ByteSizeFunction table[] = 
+	{ &DerivedSerializableObjectPolicy<Derived>::byteSize... };
+    Bricks_REQUIRE( index >= 0 && index < num_derived_types );
+    return table[index]();
+}
+
+//---------------------------------------------------------------------------//
+// Make an object hold a new object of a derived class.
+template<class Base, class... Derived>
+template<class DerivedObject>
+void AbstractObjectRegistry<Base,Derived...>::createDerived( Base& object )
+{
+    object = DerivedObject();
+}
+
+//---------------------------------------------------------------------------//
+// Get the name of a derived class.
+template<class Base, class... Derived>
+template<class DerivedObject>
+std::string AbstractObjectRegistry<Base,Derived...>::derivedObjectType()
 {
-    AbstractObjectRegistrationPolicy<Derived1>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived2>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived3>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived4>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived5>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived6>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived7>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived8>::registerDerivedClassWithBaseClass();
-    AbstractObjectRegistrationPolicy<Derived9>::registerDerivedClassWithBaseClass();
+    static_assert( 
+	HasDerivedObjectType<DerivedBuildableObjectPolicy<DerivedObject> >::value,
+	"Derived classes in a registry must be named by their "
+	"DerivedBuildableObjectPolicy." );
+    return Bricks::derivedObjectType<Base,DerivedObject>();
 }
 
 //---------------------------------------------------------------------------//
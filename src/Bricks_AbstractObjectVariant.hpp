@@ -0,0 +1,276 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractObjectVariant.hpp
+ * \author Stuart R. Slattery
+ * \brief Inline storage for a closed set of derived classes.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTOBJECTVARIANT_HPP
+#define Bricks_ABSTRACTOBJECTVARIANT_HPP
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "Bricks_AbstractObjectRegistry.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class VariantStorage
+  \brief Compile time size and alignment of the storage for a list of
+  derived classes.
+*/
+//---------------------------------------------------------------------------//
+template<class... List>
+struct VariantStorage;
+
+template<>
+struct VariantStorage<>
+{
+    static constexpr std::size_t size()
+    { return 1; }
+
+    static constexpr std::size_t align()
+    { return 1; }
+};
+
+template<class T, class... List>
+struct VariantStorage<T,List...>
+{
+    static constexpr std::size_t size()
+    { 
+	return ( sizeof(T) > VariantStorage<List...>::size() )
+	    ? sizeof(T) : VariantStorage<List...>::size();
+    }
+
+    static constexpr std::size_t align()
+    { 
+	return ( std::alignment_of<T>::value > VariantStorage<List...>::align() )
+	    ? std::alignment_of<T>::value : VariantStorage<List...>::align();
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class AbstractObjectVariant
+  \brief Value-semantic storage for an object of one of a closed set of
+  derived classes.
+
+  The variant holds an object of any of the derived classes of an
+  AbstractObjectRegistry directly in its own storage, sized and aligned for
+  the largest derived class, instead of through a heap allocated
+  implementation. Arrays of variants are contiguous and creating, copying and
+  destroying the objects they hold does not allocate beyond what the derived
+  classes allocate themselves. The derived classes must be default and copy
+  constructible.
+
+  The derived classes are meant to hold their data themselves. Value handle
+  base classes, whose derived class constructors allocate an implementation
+  that is shared by copies, are not supported: their implementation would
+  still be allocated on the heap and copies of a variant would share it.
+  Handle types are serialized with AbstractSerializer instead.
+
+  The held derived class is identified by its position in the registry,
+  which is not its builder integral key in general. Registry::position()
+  maps integral keys to positions. Objects are created by position with create() and
+  emplace() in place of an AbstractBuilder. Operations dispatch through flat
+  tables indexed by the position so apply() calls a visitor with the held
+  object as its derived class. A variant may also be empty.
+*/
+//---------------------------------------------------------------------------//
+template<class Base, class... Derived>
+class AbstractObjectVariant
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef Base                                        base_type;
+    typedef AbstractObjectRegistry<Base,Derived...>     Registry;
+    //@}
+
+    //! Number of derived classes.
+    static const int num_derived_types = sizeof...(Derived);
+
+    // Default constructor. The variant is empty.
+    AbstractObjectVariant();
+
+    // Copy constructor.
+    AbstractObjectVariant( const AbstractObjectVariant& rhs );
+
+    // Move constructor.
+    AbstractObjectVariant( AbstractObjectVariant&& rhs );
+
+    // Copy assignment operator.
+    AbstractObjectVariant& operator=( const AbstractObjectVariant& rhs );
+
+    // Move assignment operator.
+    AbstractObjectVariant& operator=( AbstractObjectVariant&& rhs );
+
+    // Destructor.
+    ~AbstractObjectVariant();
+
+    // Create a variant holding a default constructed object of the derived
+    // class at a position in the registry.
+    static AbstractObjectVariant create( const int index );
+
+    // Default construct an object of the derived class at a position in the
+    // registry in place of the held object.
+    void emplace( const int index );
+
+    // Default construct an object of a derived class in place of the held
+    // object.
+    template<class DerivedObject>
+    DerivedObject& emplace();
+
+    // Copy an object of a derived class in place of the held object.
+    template<class DerivedObject>
+    DerivedObject& assign( const DerivedObject& object );
+
+    // Destroy the held object.
+    void clear();
+
+    //! Get the registry position of the held derived class. -1 if empty.
+    int index() const
+    { return d_index; }
+
+    //! Check if the variant is empty.
+    bool empty() const
+    { return d_index < 0; }
+
+    //! Check if the variant holds an object of a derived class.
+    template<class DerivedObject>
+    bool holds() const
+    { return Registry::template index<DerivedObject>() == d_index; }
+
+    // Get the name of the held derived class.
+    std::string objectType() const;
+
+    // Get the held object through the base class.
+    Base& get();
+    const Base& get() const;
+
+    // Get the held object as its derived class.
+    template<class DerivedObject>
+    DerivedObject& get();
+    template<class DerivedObject>
+    const DerivedObject& get() const;
+
+    //! Dereference operators.
+    Base& operator*() { return get(); }
+    const Base& operator*() const { return get(); }
+    Base* operator->() { return &get(); }
+    const Base* operator->() const { return &get(); }
+
+    // Call a visitor with the held object as its derived class.
+    template<class Visitor>
+    void apply( Visitor& visitor );
+    template<class Visitor>
+    void apply( Visitor& visitor ) const;
+
+  private:
+
+    // Function table entries.
+    typedef void (*DefaultFunction)( void* );
+    typedef void (*CopyFunction)( const void*, void* );
+    typedef void (*MoveFunction)( void*, void* );
+    typedef void (*DestroyFunction)( void* );
+    typedef Base* (*BaseFunction)( void* );
+
+    // Default construct a derived class object in storage.
+    template<class DerivedObject>
+    static void defaultDerived( void* storage );
+
+    // Copy construct a derived class object in storage.
+    template<class DerivedObject>
+    static void copyDerived( const void* source, void* storage );
+
+    // Move construct a derived class object in storage.
+    template<class DerivedObject>
+    static void moveDerived( void* source, void* storage );
+
+    // Destroy a derived class object in storage.
+    template<class DerivedObject>
+    static void destroyDerived( void* storage );
+
+    // Get a derived class object in storage through the base class.
+    template<class DerivedObject>
+    static Base* baseDerived( void* storage );
+
+    // Call a visitor with a derived class object in storage.
+    template<class Visitor, class DerivedObject>
+    static void applyDerived( Visitor& visitor, void* storage );
+
+    // Copy the object held by another variant into empty storage.
+    void copyFrom( const AbstractObjectVariant& rhs );
+
+    // Move the object held by another variant into empty storage.
+    void moveFrom( AbstractObjectVariant& rhs );
+
+    // Get the storage.
+    void* storage() const
+    { return const_cast<void*>( static_cast<const void*>(&d_storage) ); }
+
+  private:
+
+    // Storage for the held object.
+    typename std::aligned_storage<
+	VariantStorage<Derived...>::size(),
+	VariantStorage<Derived...>::align()>::type d_storage;
+
+    // Registry position of the held derived class.
+    int d_index;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_AbstractObjectVariant_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTOBJECTVARIANT_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractObjectVariant.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,406 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractObjectVariant_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Inline storage for a closed set of derived classes.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTOBJECTVARIANT_IMPL_HPP
+#define Bricks_ABSTRACTOBJECTVARIANT_IMPL_HPP
+
+#include <new>
+#include <utility>
+
+#include "Bricks_DBC.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Number of derived classes.
+template<class Base, class... Derived>
+const int AbstractObjectVariant<Base,Derived...>::num_derived_types;
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Default constructor. The variant is empty.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>::AbstractObjectVariant()
+    : d_index( -1 )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Copy constructor.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>::AbstractObjectVariant( 
+    const AbstractObjectVariant& rhs )
+    : d_index( -1 )
+{
+    copyFrom( rhs );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Move constructor. The moved from object is left in the variant.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>::AbstractObjectVariant( 
+    AbstractObjectVariant&& rhs )
+    : d_index( -1 )
+{
+    moveFrom( rhs );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Copy assignment operator.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>& 
+AbstractObjectVariant<Base,Derived...>::operator=( 
+    const AbstractObjectVariant& rhs )
+{
+    if ( this != &rhs )
+    {
+	clear();
+	copyFrom( rhs );
+    }
+    return *this;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Move assignment operator.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>& 
+AbstractObjectVariant<Base,Derived...>::operator=( 
+    AbstractObjectVariant&& rhs )
+{
+    if ( this != &rhs )
+    {
+	clear();
+	moveFrom( rhs );
+    }
+    return *this;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Destructor.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...>::~AbstractObjectVariant()
+{
+    clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Create a variant holding a default constructed object of the
+ * derived class at a position in the registry.
+ */
+template<class Base, class... Derived>
+AbstractObjectVariant<Base,Derived...> 
+AbstractObjectVariant<Base,Derived...>::create( const int index )
+{
+    AbstractObjectVariant variant;
+    variant.emplace( index );
+    return variant;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Default construct an object of the derived class at a position in
+ * the registry in place of the held object.
+ */
+template<class Base, class... Derived>
+void AbstractObjectVariant<Base,Derived...>::emplace( const int index )
+{
+    static constexpr DefaultFunction table[] = 
+	{ &AbstractObjectVariant::template defaultDerived<Derived>... };
+    Bricks_REQUIRE( index >= 0 && index < num_derived_types );
+    clear();
+    table[index]( storage() );
+    d_index = index;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Default construct an object of a derived class in place of the held
+ * object.
+ */
+template<class Base, class... Derived>
+template<class DerivedObject>
+DerivedObject& AbstractObjectVariant<Base,Derived...>::emplace()
+{
+    clear();
+    defaultDerived<DerivedObject>( storage() );
+    d_index = Registry::template index<DerivedObject>();
+    return get<DerivedObject>();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Copy an object of a derived class in place of the held object.
+ */
+template<class Base, class... Derived>
+template<class DerivedObject>
+DerivedObject& AbstractObjectVariant<Base,Derived...>::assign( 
+    const DerivedObject& object )
+{
+    Bricks_REQUIRE( empty() || 
+		    static_cast<const void*>(&object) != storage() );
+    clear();
+    copyDerived<DerivedObject>( &object, storage() );
+    d_index = Registry::template index<DerivedObject>();
+    return get<DerivedObject>();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Destroy the held object.
+ */
+template<class Base, class... Derived>
+void AbstractObjectVariant<Base,Derived...>::clear()
+{
+    static constexpr DestroyFunction table[] = 
+	{ &AbstractObjectVariant::template destroyDerived<Derived>... };
+    if ( !empty() )
+    {
+	table[d_index]( storage() );
+	d_index = -1;
+    }
+    Bricks_ENSURE( empty() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the name of the held derived class.
+ */
+template<class Base, class... Derived>
+std::string AbstractObjectVariant<Base,Derived...>::objectType() const
+{
+    Bricks_REQUIRE( !empty() );
+    return Registry::objectType( d_index );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the held object through the base class.
+ */
+template<class Base, class... Derived>
+Base& AbstractObjectVariant<Base,Derived...>::get()
+{
+    static constexpr BaseFunction table[] = 
+	{ &AbstractObjectVariant::template baseDerived<Derived>... };
+    Bricks_REQUIRE( !empty() );
+    return *table[d_index]( storage() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the held object through the base class.
+ */
+template<class Base, class... Derived>
+const Base& AbstractObjectVariant<Base,Derived...>::get() const
+{
+    return const_cast<AbstractObjectVariant*>(this)->get();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the held object as its derived class.
+ */
+template<class Base, class... Derived>
+template<class DerivedObject>
+DerivedObject& AbstractObjectVariant<Base,Derived...>::get()
+{
+    Bricks_REQUIRE( holds<DerivedObject>() );
+    return *static_cast<DerivedObject*>( storage() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the held object as its derived class.
+ */
+template<class Base, class... Derived>
+template<class DerivedObject>
+const DerivedObject& AbstractObjectVariant<Base,Derived...>::get() const
+{
+    Bricks_REQUIRE( holds<DerivedObject>() );
+    return *static_cast<const DerivedObject*>( storage() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Call a visitor with the held object as its derived class. The
+ * visitor must be callable with a reference to every derived class.
+ */
+template<class Base, class... Derived>
+template<class Visitor>
+void AbstractObjectVariant<Base,Derived...>::apply( Visitor& visitor )
+{
+    typedef void (*ApplyFunction)( Visitor&, void* );
+    static constexpr ApplyFunction table[] = 
+	{ &AbstractObjectVariant::template applyDerived<Visitor,Derived>... };
+    Bricks_REQUIRE( !empty() );
+    table[d_index]( visitor, storage() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Call a visitor with the held object as its derived class. The
+ * visitor must be callable with a const reference to every derived class.
+ */
+template<class Base, class... Derived>
+template<class Visitor>
+void AbstractObjectVariant<Base,Derived...>::apply( Visitor& visitor ) const
+{
+    typedef void (*ApplyFunction)( Visitor&, void* );
+    static constexpr ApplyFunction table[] = 
+	{ &AbstractObjectVariant::template applyDerived<
+	    Visitor,const Derived>... };
+    Bricks_REQUIRE( !empty() );
+    table[d_index]( visitor, storage() );
+}
+
+//---------------------------------------------------------------------------//
+// Default construct a derived class object in storage.
+template<class Base, class... Derived>
+template<class DerivedObject>
+void AbstractObjectVariant<Base,Derived...>::defaultDerived( void* storage )
+{
+    static_assert( std::is_base_of<Base,DerivedObject>::value,
+		   "Variant objects must derive from the base class" );
+    new (storage) DerivedObject();
+}
+
+//---------------------------------------------------------------------------//
+// Copy construct a derived class object in storage.
+template<class Base, class... Derived>
+template<class DerivedObject>
+void AbstractObjectVariant<Base,Derived...>::copyDerived( const void* source,
+							 void* storage )
+{
+    new (storage) DerivedObject( 
+	*static_cast<const DerivedObject*>(source) );
+}
+
+//---------------------------------------------------------------------------//
+// Move construct a derived class object in storage.
+template<class Base, class... Derived>
+template<class DerivedObject>
+void AbstractObjectVariant<Base,Derived...>::moveDerived( void* source,
+							 void* storage )
+{
+    new (storage) DerivedObject( 
+	std::move(*static_cast<DerivedObject*>(source)) );
+}
+
+//---------------------------------------------------------------------------//
+// Destroy a derived class object in storage.
+template<class Base, class... Derived>
+template<class DerivedObject>
+void AbstractObjectVariant<Base,Derived...>::destroyDerived( void* storage )
+{
+    static_cast<DerivedObject*>(storage)->~DerivedObject();
+}
+
+//---------------------------------------------------------------------------//
+// Get a derived class object in storage through the base class.
+template<class Base, class... Derived>
+template<class DerivedObject>
+Base* AbstractObjectVariant<Base,Derived...>::baseDerived( void* storage )
+{
+    return static_cast<DerivedObject*>(storage);
+}
+
+//---------------------------------------------------------------------------//
+// Call a visitor with a derived class object in storage.
+template<class Base, class... Derived>
+template<class Visitor, class DerivedObject>
+void AbstractObjectVariant<Base,Derived...>::applyDerived( Visitor& visitor,
+							  void* storage )
+{
+    visitor( *static_cast<DerivedObject*>(storage) );
+}
+
+//---------------------------------------------------------------------------//
+// Copy the object held by another variant into empty storage.
+template<class Base, class... Derived>
+void AbstractObjectVariant<Base,Derived...>::copyFrom( 
+    const AbstractObjectVariant& rhs )
+{
+    static constexpr CopyFunction table[] = 
+	{ &AbstractObjectVariant::template copyDerived<Derived>... };
+    Bricks_REQUIRE( empty() );
+    if ( !rhs.empty() )
+    {
+	table[rhs.d_index]( rhs.storage(), storage() );
+	d_index = rhs.d_index;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Move the object held by another variant into empty storage.
+template<class Base, class... Derived>
+void AbstractObjectVariant<Base,Derived...>::moveFrom( 
+    AbstractObjectVariant& rhs )
+{
+    static constexpr MoveFunction table[] = 
+	{ &AbstractObjectVariant::template moveDerived<Derived>... };
+    Bricks_REQUIRE( empty() );
+    if ( !rhs.empty() )
+    {
+	table[rhs.d_index]( rhs.storage(), storage() );
+	d_index = rhs.d_index;
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTOBJECTVARIANT_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractObjectVariant_impl.hpp
+//---------------------------------------------------------------------------//
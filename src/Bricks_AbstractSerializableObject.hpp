@@ -42,15 +42,26 @@
 #define Bricks_ABSTRACTSERIALIZABLEOBJECT_HPP
 
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "Bricks_DBC.hpp"
 #include "Bricks_AbstractBuilder.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayView.hpp>
 
 namespace Bricks
 {
+//---------------------------------------------------------------------------//
+// Forward declarations of the buildable object policies and the derived
+// class names used to identify derived classes at registration.
+template<class T> class AbstractBuildableObjectPolicy;
+template<class T> class DerivedBuildableObjectPolicy;
+template<class DBOP> class HasDerivedObjectType;
+template<class Base, class Derived> std::string derivedObjectType();
+
 //---------------------------------------------------------------------------//
 /*!
   \class UndefinedDerivedSerializableObjectPolicy
@@ -87,7 +98,9 @@ class DerivedSerializableObjectPolicy
     //@{
     //! Serialization functions.
     /*!
-     * \brief Get the byte size of derived class.
+     * \brief Get the byte size of derived class. Specializations may declare
+     * this function constexpr so registries of derived classes can compute
+     * byte sizes at compile time.
      * \return The byte size of the derived class.
      */
     static std::size_t byteSize()
@@ -157,6 +170,65 @@ class AbstractSerializableObjectPolicy
 	return 0;
     }
 
+    /*!
+     * \brief Optional. Get the byte size of a derived class of the given base
+     * class.
+     * \param integral_key The builder integral key of the derived class.
+     * \return The byte size of the derived class. Serializers fall back to
+     * maxByteSize() if this function is not implemented.
+     *
+     * static std::size_t derivedClassByteSize( const int integral_key );
+     */
+
+    /*!
+     * \brief Optional. Get the byte size of an object.
+     * \param object Get the byte size of this object. The object has an
+     * implementation.
+     * \return The byte size of the serialized object. Objects with run time
+     * sized data may return a different size for each object. Serializers
+     * size every record exactly with this function in all formats but the
+     * fixed stride format and write the size in the record. Records have the
+     * byte size of their derived class if this function is not implemented.
+     *
+     * static std::size_t objectByteSize( const T& object );
+     */
+
+    /*!
+     * \brief Optional. Get the version of an object.
+     * \param object Get the version of this object. The object has an
+     * implementation.
+     * \return The version of the object. The version must change whenever
+     * the data or the derived class of the object changes, for example by
+     * taking it from a global counter. Delta serialization only sends the
+     * objects with a new version and sends every object if this function is
+     * not implemented.
+     *
+     * static std::size_t objectVersion( const T& object );
+     */
+
+    /*!
+     * \brief Optional. Get whether objects are serialized as their bytes.
+     * \return True if serialize() writes the bytes of the object itself and
+     * the derived class byte size is the size of the object type. Serializers
+     * then copy batches of objects of one derived class as one block when
+     * the object type is trivially copyable. Objects are serialized one at a
+     * time if this function is not implemented.
+     *
+     * static bool bitwiseSerializable();
+     */
+
+    /*!
+     * \brief Optional. The registry of the derived classes of the given base
+     * class. Serializers create objects and get the byte size of derived
+     * classes through the flat tables of the registry, at the position
+     * the registry maps from the integral key, instead of the builder
+     * factories and derivedClassByteSize() if this type is defined, and take the maximum byte size from the registry
+     * type list instead of maxByteSize(). Objects from the builder pool are
+     * still acquired from the builder.
+     *
+     * typedef AbstractObjectRegistry<T,Derived...> registry_type;
+     */
+
     /*
      * \brief Serialize the subclass into a buffer.
      * \param object Serialize this object into the buffer.
@@ -183,14 +255,135 @@ class AbstractSerializableObjectPolicy
     //@}
 };
 
+//---------------------------------------------------------------------------//
+/*!
+  \class HasDerivedClassByteSize
+  \brief Compile time check for the optional derivedClassByteSize() function
+  of a serializable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ASOP>
+class HasDerivedClassByteSize
+{
+  private:
+
+    template<class U>
+    static std::true_type check( decltype(U::derivedClassByteSize(0))* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ASOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasObjectVersion
+  \brief Compile time check for the optional objectVersion() function of a
+  serializable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ASOP>
+class HasObjectVersion
+{
+  private:
+
+    template<class U>
+    static std::true_type check( 
+	decltype(U::objectVersion(std::declval<typename U::object_type>()))* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ASOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasObjectByteSize
+  \brief Compile time check for the optional objectByteSize() function of a
+  serializable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ASOP>
+class HasObjectByteSize
+{
+  private:
+
+    template<class U>
+    static std::true_type check( 
+	decltype(U::objectByteSize(std::declval<typename U::object_type>()))* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ASOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasBitwiseSerializable
+  \brief Compile time check for the optional bitwiseSerializable() function
+  of a serializable object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ASOP>
+class HasBitwiseSerializable
+{
+  private:
+
+    template<class U>
+    static std::true_type check( decltype(U::bitwiseSerializable())* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ASOP>(0))::value;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \class HasRegistryType
+  \brief Compile time check for the optional registry_type of a serializable
+  object policy.
+*/
+//---------------------------------------------------------------------------//
+template<class ASOP>
+class HasRegistryType
+{
+  private:
+
+    template<class U>
+    static std::true_type check( typename U::registry_type* );
+
+    template<class U>
+    static std::false_type check( ... );
+
+  public:
+
+    static const bool value = decltype(check<ASOP>(0))::value;
+};
+
 //---------------------------------------------------------------------------//
 /*!
   \class AbstractSerializableObject
   \brief Interface definition for objects that can be serialized.
 
   This class provides a static mechanism to track the byte size of a base
-  class as the maximum size of its derived classes. Derived classes must
-  register with this class.
+  class as the maximum size of its derived classes. The byte size of each
+  derived class is also tracked by its builder integral key. Derived classes
+  must register with this class. Byte sizes set for a derived class type are
+  matched to its integral key when a byte size is first requested after the
+  derived class factory is set with the builder, so the factory and the byte
+  size may be set in either order.
 */
 //---------------------------------------------------------------------------//
 template<class Object>
@@ -218,10 +411,22 @@ class AbstractSerializableObject
      */
     static std::size_t maxByteSize();
 
+    /*!
+     * \brief Get the byte size of a derived class of the given base class.
+     * \param integral_key The builder integral key of the derived class.
+     * \return The byte size of the derived class. If no byte size was
+     * registered for the derived class the maximum byte size is returned.
+     */
+    static std::size_t derivedClassByteSize( const int integral_key );
+
     /*
      * \brief Set the byte size of a derived class with the base class for a
-     * derived class implementing the DerivedSerializableObjectPolicy.
-     * \param byte_size The byte size of the derived class.
+     * derived class implementing the DerivedSerializableObjectPolicy. If
+     * the DerivedBuildableObjectPolicy of the derived class names it, the
+     * byte size is tracked by integral key once the derived class factory is
+     * registered with the base class builder. Otherwise only the maximum
+     * byte size is set so no object of the derived class is constructed to
+     * find its name.
      */
     template<class DerivedObject>
     static void setDerivedClassByteSize();
@@ -232,10 +437,50 @@ class AbstractSerializableObject
      */
     static void setDerivedClassByteSize( const std::size_t bytes );
 
+    /*
+     * \brief Set the byte size of a derived class with the base class.
+     * \param integral_key The builder integral key of the derived class.
+     * \param byte_size The byte size of the derived class.
+     */
+    static void setDerivedClassByteSize( const int integral_key,
+					 const std::size_t bytes );
+
+  private:
+
+    // Function giving the name of a derived class.
+    typedef std::string (*NameFunction)();
+
+    // Track the byte sizes set by derived class type with the integral key
+    // of their derived class.
+    static void resolveDerivedClassByteSizes();
+
+    // Track the byte size of a derived class named by its
+    // DerivedBuildableObjectPolicy.
+    template<class DerivedObject>
+    static void trackDerivedClassByteSize( const std::size_t bytes,
+					   std::true_type );
+
+    // Derived classes without a static name are not tracked.
+    template<class DerivedObject>
+    static void trackDerivedClassByteSize( const std::size_t bytes,
+					   std::false_type );
+
   private:
 
     // Maximum byte size for the base class.
     static std::size_t b_max_byte_size;
+
+    // Derived class byte sizes indexed by integral key.
+    static Teuchos::Array<std::size_t> b_byte_sizes;
+
+    // Derived class byte sizes waiting for the integral key of their derived
+    // class.
+    static Teuchos::Array<std::pair<NameFunction,std::size_t> > 
+    b_pending_byte_sizes;
+
+    // Number of derived classes in the builder when the pending byte sizes
+    // were last tracked.
+    static int b_num_resolved_classes;
 };
 
 //---------------------------------------------------------------------------//
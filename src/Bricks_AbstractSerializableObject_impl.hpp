@@ -70,6 +70,24 @@ AbstractSerializableObject<Object>::~AbstractSerializableObject()
 template<class Object>
 std::size_t AbstractSerializableObject<Object>::b_max_byte_size = 0;
 
+//---------------------------------------------------------------------------//
+// Derived class byte sizes.
+template<class Object>
+Teuchos::Array<std::size_t> AbstractSerializableObject<Object>::b_byte_sizes;
+
+//---------------------------------------------------------------------------//
+// Derived class byte sizes waiting for their integral key.
+template<class Object>
+Teuchos::Array<std::pair<
+		   typename AbstractSerializableObject<Object>::NameFunction,
+		   std::size_t> > 
+AbstractSerializableObject<Object>::b_pending_byte_sizes;
+
+//---------------------------------------------------------------------------//
+// Number of derived classes when the pending byte sizes were last tracked.
+template<class Object>
+int AbstractSerializableObject<Object>::b_num_resolved_classes = 0;
+
 //---------------------------------------------------------------------------//
 // Get the maximum byte size of subclasses of the given base class.
 template<class Object>
@@ -78,6 +96,19 @@ std::size_t AbstractSerializableObject<Object>::maxByteSize()
     return b_max_byte_size;
 }
 
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class of the given base class.
+template<class Object>
+std::size_t AbstractSerializableObject<Object>::derivedClassByteSize(
+    const int integral_key )
+{ 
+    Bricks_REQUIRE( integral_key >= 0 );
+    resolveDerivedClassByteSizes();
+    return ( integral_key < b_byte_sizes.size() && 
+	     b_byte_sizes[integral_key] > 0 )
+	? b_byte_sizes[integral_key] : b_max_byte_size;
+}
+
 //---------------------------------------------------------------------------//
 // Set the byte size of a derived class with the base class.
 template<class Object>
@@ -87,6 +118,21 @@ void AbstractSerializableObject<Object>::setDerivedClassByteSize(
     b_max_byte_size = std::max( b_max_byte_size, bytes );
 }
 
+//---------------------------------------------------------------------------//
+// Set the byte size of a derived class with the base class by integral key.
+template<class Object>
+void AbstractSerializableObject<Object>::setDerivedClassByteSize(
+    const int integral_key, const std::size_t bytes )
+{
+    Bricks_REQUIRE( integral_key >= 0 );
+    if ( b_byte_sizes.size() <= integral_key )
+    {
+	b_byte_sizes.resize( integral_key + 1, 0 );
+    }
+    b_byte_sizes[integral_key] = bytes;
+    setDerivedClassByteSize( bytes );
+}
+
 //---------------------------------------------------------------------------//
 // Set the byte size of a derived class with the base class for a derived
 // class implementing the DerivedSerializableObjectPolicy.
@@ -94,8 +140,76 @@ template<class Object>
 template<class DerivedObject>
 void AbstractSerializableObject<Object>::setDerivedClassByteSize()
 {
-    setDerivedClassByteSize(
-	DerivedSerializableObjectPolicy<DerivedObject>::byteSize() );
+    std::size_t bytes = 
+	DerivedSerializableObjectPolicy<DerivedObject>::byteSize();
+    trackDerivedClassByteSize<DerivedObject>( 
+	bytes,
+	std::integral_constant<
+	    bool,
+	    HasDerivedObjectType<
+		DerivedBuildableObjectPolicy<DerivedObject> >::value>() );
+    setDerivedClassByteSize( bytes );
+}
+
+//---------------------------------------------------------------------------//
+// Track the byte size of a derived class named by its
+// DerivedBuildableObjectPolicy.
+template<class Object>
+template<class DerivedObject>
+void AbstractSerializableObject<Object>::trackDerivedClassByteSize(
+    const std::size_t bytes, std::true_type )
+{
+    b_pending_byte_sizes.push_back( 
+	std::make_pair(&derivedObjectType<Object,DerivedObject>, bytes) );
+    b_num_resolved_classes = 0;
+}
+
+//---------------------------------------------------------------------------//
+// Derived classes without a static name are not tracked. Their byte size is
+// the maximum byte size.
+template<class Object>
+template<class DerivedObject>
+void AbstractSerializableObject<Object>::trackDerivedClassByteSize(
+    const std::size_t, std::false_type )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Track the byte sizes set by derived class type with the integral key of
+// their derived class. Byte sizes for derived classes not yet set with the
+// builder stay pending and are only checked again when the builder has more
+// derived classes.
+template<class Object>
+void AbstractSerializableObject<Object>::resolveDerivedClassByteSizes()
+{
+    if ( b_pending_byte_sizes.empty() )
+    {
+	return;
+    }
+
+    typedef AbstractBuildableObjectPolicy<Object> ABOP;
+    Teuchos::RCP<AbstractBuilder<Object> > builder = ABOP::getBuilder();
+    if ( builder->numDerivedClasses() == b_num_resolved_classes )
+    {
+	return;
+    }
+    b_num_resolved_classes = builder->numDerivedClasses();
+
+    Teuchos::Array<std::pair<NameFunction,std::size_t> > pending;
+    std::string name;
+    for ( int n = 0; n < b_pending_byte_sizes.size(); ++n )
+    {
+	name = b_pending_byte_sizes[n].first();
+	if ( builder->hasDerivedClass(name) )
+	{
+	    setDerivedClassByteSize( builder->getIntegralKey(name),
+				     b_pending_byte_sizes[n].second );
+	}
+	else
+	{
+	    pending.push_back( b_pending_byte_sizes[n] );
+	}
+    }
+    b_pending_byte_sizes.swap( pending );
 }
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractSerializedIterator.hpp
+ * \author Stuart R. Slattery
+ * \brief Iterator over abstract objects in a serialized buffer.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTSERIALIZEDITERATOR_HPP
+#define Bricks_ABSTRACTSERIALIZEDITERATOR_HPP
+
+#include <functional>
+
+#include "Bricks_AbstractIterator.hpp"
+#include "Bricks_AbstractSerializer.hpp"
+
+#include <Teuchos_ArrayRCP.hpp>
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class AbstractSerializedIterator
+  \brief Iterator over abstract objects in a serialized buffer.
+
+  The iterator walks the records of an indirect char buffer from
+  AbstractSerializer in the wire format. The layout and key size of the
+  records are read from the header of the buffer at construction, so the
+  iterator does not depend on later changes to the serializer settings. A
+  record is deserialized into a
+  single object owned by the iterator when it is dereferenced, so iterating
+  over a buffer needs memory for one object instead of the whole array. The
+  object is reused for the following records and is deserialized in place
+  when they have the same derived class. A dereferenced object is therefore
+  only valid until the iterator is incremented and copies of it share its
+  data. The run length and homogeneous formats are not supported.
+*/
+//---------------------------------------------------------------------------//
+template<class T>
+class AbstractSerializedIterator : public AbstractIterator<T>
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef T                                   value_type;
+    typedef AbstractSerializer<int,T>           Serializer;
+    //@}
+
+    /*!
+     * \brief Default constructor.
+     */
+    AbstractSerializedIterator();
+
+    /*!
+     * \brief Constructor.
+     */
+    explicit AbstractSerializedIterator( 
+	const Teuchos::ArrayRCP<const char>& buffer );
+
+    /*!
+     * \brief Predicate constructor.
+     */
+    AbstractSerializedIterator( const Teuchos::ArrayRCP<const char>& buffer,
+				const std::function<bool(T&)>& predicate );
+
+    /*!
+     * \brief Copy constructor.
+     */
+    AbstractSerializedIterator( const AbstractSerializedIterator<T>& rhs );
+
+    /*!
+     * \brief Assignment operator.
+     */
+    AbstractSerializedIterator& 
+    operator=( const AbstractSerializedIterator<T>& rhs );
+
+    /*!
+     * \brief Destructor.
+     */
+    ~AbstractSerializedIterator();
+
+    // Pre-increment operator.
+    AbstractIterator<T>& operator++();
+
+    // Dereference operator.
+    T& operator*(void);
+
+    // Dereference operator.
+    T* operator->(void);
+
+    // Equal comparison operator.
+    bool operator==( const AbstractIterator<T>& rhs ) const;
+
+    // Not equal comparison operator.
+    bool operator!=( const AbstractIterator<T>& rhs ) const;
+
+    // Number of records in the buffer.
+    std::size_t size() const;
+
+    // An iterator assigned to the first record.
+    AbstractIterator<T> begin() const;
+
+    // An iterator assigned to the end of the records.
+    AbstractIterator<T> end() const;
+
+  protected:
+
+    // Create a clone of the iterator.
+    AbstractIterator<T>* clone() const;
+
+  private:
+
+    // Serialized buffer.
+    Teuchos::ArrayRCP<const char> d_buffer;
+
+    // Layout of the records in the buffer.
+    typename Serializer::Format d_format;
+
+    // Byte size of the integral keys in the buffer.
+    std::size_t d_key_size;
+
+    // Number of records.
+    int d_count;
+
+    // Index of the current record.
+    int d_index;
+
+    // Current record.
+    const char* d_record;
+
+    // Object for the current record.
+    T d_object;
+
+    // Current record deserialized flag.
+    bool d_deserialized;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_AbstractSerializedIterator_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTSERIALIZEDITERATOR_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractSerializedIterator.hpp
+//---------------------------------------------------------------------------//
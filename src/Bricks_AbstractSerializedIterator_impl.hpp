@@ -0,0 +1,259 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractSerializedIterator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Iterator over abstract objects in a serialized buffer.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTSERIALIZEDITERATOR_IMPL_HPP
+#define Bricks_ABSTRACTSERIALIZEDITERATOR_IMPL_HPP
+
+#include "Bricks_DBC.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Default constructor.
+template<class T>
+AbstractSerializedIterator<T>::AbstractSerializedIterator()
+    : d_format( Serializer::FIXED_STRIDE )
+    , d_key_size( sizeof(int) )
+    , d_count( 0 )
+    , d_index( 0 )
+    , d_record( NULL )
+    , d_deserialized( false )
+{
+    this->b_iterator_impl = NULL;
+}
+
+//---------------------------------------------------------------------------//
+// Constructor.
+template<class T>
+AbstractSerializedIterator<T>::AbstractSerializedIterator( 
+    const Teuchos::ArrayRCP<const char>& buffer )
+    : d_buffer( buffer )
+    , d_format( Serializer::packedFormat(buffer.getRawPtr()) )
+    , d_key_size( Serializer::packedKeyByteSize(buffer.getRawPtr()) )
+    , d_count( Serializer::fromPackedBytesToCount(buffer.size(),
+						   buffer.getRawPtr()) )
+    , d_index( 0 )
+    , d_record( Serializer::firstRecord(buffer.getRawPtr()) )
+    , d_deserialized( false )
+{
+    this->b_iterator_impl = NULL;
+}
+
+//---------------------------------------------------------------------------//
+// Predicate constructor.
+template<class T>
+AbstractSerializedIterator<T>::AbstractSerializedIterator( 
+    const Teuchos::ArrayRCP<const char>& buffer,
+    const std::function<bool(T&)>& predicate )
+    : d_buffer( buffer )
+    , d_format( Serializer::packedFormat(buffer.getRawPtr()) )
+    , d_key_size( Serializer::packedKeyByteSize(buffer.getRawPtr()) )
+    , d_count( Serializer::fromPackedBytesToCount(buffer.size(),
+						   buffer.getRawPtr()) )
+    , d_index( 0 )
+    , d_record( Serializer::firstRecord(buffer.getRawPtr()) )
+    , d_deserialized( false )
+{
+    this->b_iterator_impl = NULL;
+    this->b_predicate = predicate;
+}
+
+//---------------------------------------------------------------------------//
+// Copy constructor. The copy gets its own object. The base is default
+// constructed as copying it would clone this iterator again.
+template<class T>
+AbstractSerializedIterator<T>::AbstractSerializedIterator( 
+    const AbstractSerializedIterator<T>& rhs )
+    : AbstractIterator<T>()
+    , d_buffer( rhs.d_buffer )
+    , d_format( rhs.d_format )
+    , d_key_size( rhs.d_key_size )
+    , d_count( rhs.d_count )
+    , d_index( rhs.d_index )
+    , d_record( rhs.d_record )
+    , d_deserialized( false )
+{
+    this->b_iterator_impl = NULL;
+    this->b_predicate = rhs.b_predicate;
+}
+
+//---------------------------------------------------------------------------//
+// Assignment operator. The iterator keeps its own object.
+template<class T>
+AbstractSerializedIterator<T>& AbstractSerializedIterator<T>::operator=( 
+    const AbstractSerializedIterator<T>& rhs )
+{
+    this->b_iterator_impl = NULL;
+    this->b_predicate = rhs.b_predicate;
+    if ( &rhs == this )
+    {
+	return *this;
+    }
+    d_buffer = rhs.d_buffer;
+    d_format = rhs.d_format;
+    d_key_size = rhs.d_key_size;
+    d_count = rhs.d_count;
+    d_index = rhs.d_index;
+    d_record = rhs.d_record;
+    d_deserialized = false;
+    return *this;
+}
+
+//---------------------------------------------------------------------------//
+// Destructor.
+template<class T>
+AbstractSerializedIterator<T>::~AbstractSerializedIterator()
+{
+    this->b_iterator_impl = NULL;
+}
+
+//---------------------------------------------------------------------------//
+// Pre-increment operator.
+template<class T>
+AbstractIterator<T>& AbstractSerializedIterator<T>::operator++()
+{
+    Bricks_REQUIRE( d_index < d_count );
+    int integral_key = 0;
+    const char* data = NULL;
+    d_record = Serializer::nextRecord( 
+	d_format, d_key_size, d_record, integral_key, data );
+    ++d_index;
+    d_deserialized = false;
+    return *this;
+}
+
+//---------------------------------------------------------------------------//
+// Dereference operator.
+template<class T>
+T& AbstractSerializedIterator<T>::operator*(void)
+{
+    this->operator->();
+    return d_object;
+}
+
+//---------------------------------------------------------------------------//
+// Dereference operator. The current record is deserialized on the first
+// dereference.
+template<class T>
+T* AbstractSerializedIterator<T>::operator->(void)
+{
+    Bricks_REQUIRE( d_index < d_count );
+    if ( !d_deserialized )
+    {
+	int integral_key = 0;
+	const char* data = NULL;
+	Serializer::nextRecord( 
+	    d_format, d_key_size, d_record, integral_key, data );
+	Serializer::deserializeRecord( d_format, integral_key, data, d_object );
+	d_deserialized = true;
+    }
+    return &d_object;
+}
+
+//---------------------------------------------------------------------------//
+// Equal comparison operator.
+template<class T>
+bool AbstractSerializedIterator<T>::operator==( 
+    const AbstractIterator<T>& rhs ) const
+{
+    const AbstractSerializedIterator<T>* rhs_it = 
+	static_cast<const AbstractSerializedIterator<T>*>(&rhs);
+    if ( NULL != rhs_it->b_iterator_impl )
+    {
+	rhs_it = static_cast<const AbstractSerializedIterator<T>*>(
+	    rhs_it->b_iterator_impl);
+    }
+    return ( d_buffer.getRawPtr() == rhs_it->d_buffer.getRawPtr() &&
+	     d_index == rhs_it->d_index );
+}
+
+//---------------------------------------------------------------------------//
+// Not equal comparison operator.
+template<class T>
+bool AbstractSerializedIterator<T>::operator!=( 
+    const AbstractIterator<T>& rhs ) const
+{
+    return !( operator==(rhs) );
+}
+
+//---------------------------------------------------------------------------//
+// Number of records in the buffer.
+template<class T>
+std::size_t AbstractSerializedIterator<T>::size() const
+{
+    return d_count;
+}
+
+//---------------------------------------------------------------------------//
+// An iterator assigned to the first record.
+template<class T>
+AbstractIterator<T> AbstractSerializedIterator<T>::begin() const
+{
+    return AbstractSerializedIterator<T>( d_buffer, this->b_predicate );
+}
+
+//---------------------------------------------------------------------------//
+// An iterator assigned to the end of the records.
+template<class T>
+AbstractIterator<T> AbstractSerializedIterator<T>::end() const
+{
+    AbstractSerializedIterator<T> end_it( *this );
+    end_it.d_index = d_count;
+    end_it.d_record = NULL;
+    return end_it;
+}
+
+//---------------------------------------------------------------------------//
+// Create a clone of the iterator.
+template<class T>
+AbstractIterator<T>* AbstractSerializedIterator<T>::clone() const
+{
+    return new AbstractSerializedIterator<T>( *this );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+#endif // end Bricks_ABSTRACTSERIALIZEDITERATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractSerializedIterator_impl.hpp
+//---------------------------------------------------------------------------//
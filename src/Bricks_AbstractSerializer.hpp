@@ -42,11 +42,14 @@
 #define Bricks_ABSTRACTSERIALIZER_HPP
 
 #include <string>
+#include <type_traits>
+#include <functional>
 
 #include "Bricks_AbstractBuildableObject.hpp"
 #include "Bricks_AbstractSerializableObject.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayView.hpp>
 
 namespace Bricks
@@ -60,6 +63,144 @@ namespace Bricks
   implement the AbstractSerializableObjectPolicy can use this class to quickly
   implement Teuchos::SerializationTraits. This object mimics the Teuchos
   indirect serialization traits.
+
+  The traits functions always use the fixed stride format. Teuchos sizes the
+  buffer of a collective, such as a broadcast, on every process from the
+  objects that process holds, so the byte size may only depend on the number
+  of objects. The wire format set with setFormat() is used by the packed
+  functions fromCountToPackedBytes(), serializePacked(),
+  fromPackedBytesToCount() and deserializePacked(), where only the sender
+  sizes the buffer, and by the chunked serialization, the record access
+  functions and the distributor.
+
+  Packed buffers begin with a header that holds the layout of their records
+  as a format tag and the byte size of their integral keys. The receiving
+  side reads the records with the layout in the header, not with its own
+  format setting, so a sender and a receiver with different format settings
+  still agree on the buffer. The header is not written by the traits
+  functions.
+
+  Two wire formats are available. In the fixed stride format every record is
+  an integral key followed by ASOP::maxByteSize() bytes. In the compact format
+  the buffer begins with the number of records and every record is an
+  integral key followed by the byte size of its own derived class as given by
+  the optional ASOP::derivedClassByteSize() function. Records for objects
+  without an implementation have a negative key and no data. The receiving
+  side reads the format from the header of the buffer.
+
+  The homogeneous format is for batches of objects of a single derived
+  class. Each batch is checked when it is packed and the buffer begins with
+  an integral key. If every object has an implementation of the same derived
+  class the key is the key of that class and is followed by the number of
+  objects and the data of every object, each with the byte size of the
+  derived class, in one contiguous block. Otherwise the key is negative and
+  is followed by the batch in the compact format, so batches with mixed
+  derived classes or objects without an implementation are still packed. If
+  the object type is trivially copyable and the optional
+  ASOP::bitwiseSerializable() function returns true, a homogeneous batch
+  whose derived class byte size is the size of the object type is copied as
+  one block. The block copy only applies to plain object types with their
+  own policies, such as a point type built by a builder with a single
+  derived class. It never applies to classes derived from
+  AbstractBuildableObject, which have a virtual destructor and so are not
+  trivially copyable, or to value handle base classes. Their homogeneous
+  batches still share one key but each object is serialized by the policy.
+  The homogeneous format is chosen with setFormat() and is not detected from
+  the builder or the registry.
+
+  The run length format is for batches sorted by derived class. The buffer
+  begins with the number of records and each run of records with the same
+  integral key is the key and the number of records in the run followed by
+  the data of each record with the byte size of its derived class.
+
+  Objects with run time sized data implement the optional
+  ASOP::objectByteSize() function. The compact and run length records then
+  write the byte size of the data of each object before its data so every
+  record has its exact size, and the homogeneous format falls back to the
+  compact format. Buffers are sized exactly by fromCountToPackedBytes()
+  before they are packed. Fixed stride records also write the byte size of
+  the data of each object but still reserve ASOP::maxByteSize() bytes, which
+  each object must fit in, so the Teuchos serialization traits functions
+  still size buffers from the number of objects only and objects with run
+  time sized data can be broadcast through them.
+
+  The integral key of each object comes from the optional
+  ABOP::objectIntegralKey() function when it is implemented so serializing an
+  object does not build the name of its type.
+
+  If the policy names an AbstractObjectRegistry as its optional
+  ASOP::registry_type, new objects are created and the byte size of each
+  derived class is found through the flat tables of the registry, at the
+  registry position mapped from the integral key, instead of the builder
+  factories. Integral keys the registry has not mapped use the builder
+  factories. The maximum byte size used
+  for fixed stride records is then the maximum over the registry type list,
+  which does not depend on the order of registration, instead of
+  ASOP::maxByteSize().
+
+  Integral keys are written as an int by default. With narrow keys they are
+  written with the smallest of a signed char, a short or an int that holds
+  every integral key of the builder. The byte size of the keys is written
+  into the header of buffers in the wire format and at the front of delta
+  buffers so the receiving side reads the keys with the width they were
+  written with, whatever the number of derived classes it has registered.
+  The Teuchos serialization traits functions have no header and always
+  write keys as an int.
+
+  Records are deserialized in order by default. With grouped deserialization
+  the integral keys are scanned first and the objects of each derived class
+  are then created and deserialized together before being written back in
+  their original order.
+
+  If the object pool of the builder is on, deserialization takes the objects
+  it needs from the pool and returns the objects they replace to the pool,
+  so repeated exchanges of a similar population of objects do not allocate.
+  A replaced object only goes to the pool if the optional
+  ABOP::objectIsShared() function reports that no copy holds its
+  implementation, so copies of replaced objects are never changed by later
+  deserialization. Replaced objects are dropped if that function is not
+  implemented.
+
+  With in-place deserialization an object in the target buffer that already
+  has the derived class of its incoming record is deserialized directly
+  without building a new object. Objects share their implementation when
+  copied, so copies of a target object will also see the new data.
+
+  With parallel packing the offsets of the records and the integral keys are
+  computed on one thread and the objects are then serialized and
+  deserialized with OpenMP threads. OpenMP is opt-in: it is enabled with the
+  Bricks_ENABLE_OpenMP option, which follows the project OpenMP setting, and
+  parallel packing otherwise runs on one thread. The output is the same as
+  with serial packing in every format. Objects are built in parallel only if
+  the builder was frozen with its factories declared thread safe and are
+  otherwise built on one thread, as are objects taken from the builder pool.
+  ASOP::serialize() and ASOP::deserialize() need only be thread safe for
+  distinct objects.
+  Parallel deserialization does not group the objects by derived class.
+
+  Records are read in order from the buffer with firstRecord() and
+  nextRecord() in the fixed stride and compact formats, with the layout and
+  key size from packedFormat() and packedKeyByteSize(). Records in the run
+  length format do not hold their key, so AbstractSerializedIterator does not
+  support it; indexRecords() and AbstractLazyArray support every format.
+
+  Large batches can be serialized in chunks. Each chunk holds as many whole
+  records as fit in the chunk size and is a complete indirect buffer in the
+  current format, so the receiver deserializes the chunks one at a time. The
+  chunks are given to a consumer, such as a send or a file write, before the
+  next chunk is packed so only one chunk is allocated at a time. The number
+  of objects in the batch is not limited by the Ordinal type.
+
+  Delta serialization sends only the objects that changed since they were
+  last sent. The sender keeps the version of each object as last sent,
+  starting from nullVersion() for a receiver holding default constructed
+  objects, and the changes are found with the optional ASOP::objectVersion()
+  function. Every object is sent if that function is not implemented. Each
+  delta record is the index of the object, its integral key and its data
+  with the byte size of its derived class, or with its own byte size
+  preceded by that size if ASOP::objectByteSize() is implemented. The
+  receiver patches its previous objects in place when the derived class is
+  unchanged.
 */
 //---------------------------------------------------------------------------//
 template<class Ordinal, class T>
@@ -74,8 +215,55 @@ class AbstractSerializer
     typedef AbstractSerializableObjectPolicy<T> ASOP;
     //@}
 
+    //! Wire formats.
+    enum Format
+    {
+	FIXED_STRIDE, //!< Records reserve the maximum byte size.
+	COMPACT,      //!< Records use their derived class byte size.
+	HOMOGENEOUS,  //!< Batches of one derived class share their key.
+	RUN_LENGTH    //!< Runs of records share one integral key.
+    };
+
+    //! Consumer of serialized chunks.
+    typedef std::function<void(const Teuchos::ArrayView<const char>&)>
+    ChunkConsumer;
+
   public:
 
+    // Set the wire format.
+    static void setFormat( const Format format );
+
+    // Get the wire format.
+    static Format format();
+
+    // Set whether records are grouped by derived class for deserialization.
+    static void setGroupedDeserialization( const bool grouped );
+
+    // Get whether records are grouped by derived class for deserialization.
+    static bool groupedDeserialization();
+
+    // Set whether objects that already have the derived class of a record
+    // are deserialized in place.
+    static void setInPlaceDeserialization( const bool in_place );
+
+    // Get whether objects that already have the derived class of a record
+    // are deserialized in place.
+    static bool inPlaceDeserialization();
+
+    // Set whether records are packed and unpacked in parallel.
+    static void setParallelPacking( const bool parallel );
+
+    // Get whether records are packed and unpacked in parallel.
+    static bool parallelPacking();
+
+    // Set whether integral keys are written with the smallest integral type
+    // that holds them.
+    static void setNarrowKeys( const bool narrow_keys );
+
+    // Get whether integral keys are written with the smallest integral type
+    // that holds them.
+    static bool narrowKeys();
+
     // Return the number of bytes for count objects.
     static Ordinal fromCountToIndirectBytes( const Ordinal count, 
 					     const T buffer[] );
@@ -96,10 +284,402 @@ class AbstractSerializer
 			     const Ordinal count, 
 			     T buffer[] );
 
+    // Return the number of bytes for count objects in the wire format.
+    static Ordinal fromCountToPackedBytes( const Ordinal count, 
+					   const T buffer[] );
+
+    // Serialize to an indirect char buffer in the wire format.
+    static void serializePacked( const Ordinal count, 
+				 const T buffer[], 
+				 const Ordinal bytes, 
+				 char charBuffer[] );
+
+    // Return the number of objects in an indirect char buffer in the wire
+    // format.
+    static Ordinal fromPackedBytesToCount( const Ordinal bytes, 
+					   const char charBuffer[] );
+
+    // Deserialize from an indirect char buffer in the wire format.
+    static void deserializePacked( const Ordinal bytes, 
+				   const char charBuffer[], 
+				   const Ordinal count, 
+				   T buffer[] );
+
+    // Serialize to a sequence of indirect char buffers of bounded size.
+    static void serializeChunked( const std::size_t count,
+				  const T buffer[],
+				  const std::size_t chunk_bytes,
+				  const ChunkConsumer& consumer );
+
+    // Deserialize one chunk of a chunked serialization.
+    static Ordinal deserializeChunk( const Teuchos::ArrayView<const char>& chunk,
+				     T buffer[] );
+
+    // Get the version recorded for an object without an implementation.
+    static std::size_t nullVersion();
+
+    // Return the number of bytes for the objects that changed since the
+    // given versions. The byte size must fit in the Ordinal type.
+    static Ordinal fromCountToDeltaBytes( 
+	const Ordinal count, 
+	const T buffer[],
+	const Teuchos::ArrayView<const std::size_t>& versions );
+
+    // Serialize the objects that changed since the given versions to an
+    // indirect char buffer.
+    static void serializeDelta( const Ordinal count, 
+				const T buffer[], 
+				const Teuchos::ArrayView<std::size_t>& versions,
+				const Ordinal bytes, 
+				char charBuffer[] );
+
+    // Patch objects with the changed objects in an indirect char buffer.
+    static void deserializeDelta( const Ordinal bytes, 
+				  const char charBuffer[], 
+				  const Ordinal count, 
+				  T buffer[] );
+
+    // Index the records in an indirect char buffer.
+    static void indexRecords( const Ordinal bytes, 
+			      const char charBuffer[], 
+			      const Ordinal count,
+			      Teuchos::Array<int>& keys,
+			      Teuchos::Array<std::size_t>& offsets );
+
+    // Get the record layout of an indirect char buffer in the wire format
+    // from its header.
+    static Format packedFormat( const char charBuffer[] );
+
+    // Get the byte size of the integral keys of an indirect char buffer in
+    // the wire format from its header.
+    static std::size_t packedKeyByteSize( const char charBuffer[] );
+
+    // Get the first record in an indirect char buffer. The run length and
+    // homogeneous formats are not supported.
+    static const char* firstRecord( const char charBuffer[] );
+
+    // Read the integral key and data of a record of a buffer in the given
+    // layout and key size and get the next record. The run length and
+    // homogeneous formats are not supported.
+    static const char* nextRecord( const Format record_layout,
+				   const std::size_t key_size,
+				   const char record[], 
+				   int& integral_key,
+				   const char*& data );
+
+    // Deserialize the data of one record of a buffer in the given layout
+    // into an object.
+    static void deserializeRecord( const Format record_layout,
+				   const int integral_key,
+				   const char data[],
+				   T& object );
+
   public:
 
-    // Direct serialization support.
+    // Direct serialization support. Always false as abstract objects are
+    // never trivially copyable.
     static const bool supportsDirectSerialization;
+
+  private:
+
+    // Get the layout of the records.
+    static Format layout();
+
+    // Get the byte size of the header of a buffer in the wire format.
+    static std::size_t headerByteSize();
+
+    // Write the header of a buffer in the wire format.
+    static void packHeader( const Format record_layout, 
+			    const std::size_t key_size,
+			    char charBuffer[] );
+
+    // Get the integral key of an object.
+    static int objectKey( const AbstractBuilder<T>& builder, 
+			  const T& object );
+
+    // Get the integral key of an object from the policy.
+    static int objectKey( const AbstractBuilder<T>& builder, 
+			  const T& object,
+			  std::true_type );
+
+    // Get the integral key of an object by the name of its type.
+    static int objectKey( const AbstractBuilder<T>& builder, 
+			  const T& object,
+			  std::false_type );
+
+    // Get the byte size of an integral key.
+    static std::size_t keyByteSize();
+
+    // Write the byte size of the integral keys of a buffer.
+    static void packKeyByteSize( const std::size_t key_size, char buffer[] );
+
+    // Read the byte size of the integral keys of a buffer.
+    static std::size_t unpackKeyByteSize( const char buffer[] );
+
+    // Write an integral key.
+    static void packKey( const int integral_key, 
+			 const std::size_t key_size,
+			 char key_buffer[] );
+
+    // Read an integral key.
+    static int unpackKey( const char key_buffer[], 
+			  const std::size_t key_size );
+
+    // Return the number of bytes for count objects in a layout.
+    static Ordinal countToBytes( const Format record_layout,
+				 const std::size_t key_size,
+				 const Ordinal count, 
+				 const T buffer[] );
+
+    // Return the number of objects for bytes of storage in a layout.
+    static Ordinal bytesToCount( const Format record_layout,
+				 const std::size_t key_size,
+				 const Ordinal bytes, 
+				 const char charBuffer[] );
+
+    // Get the byte size of the data in a record for a derived class.
+    static std::size_t recordDataByteSize( const Format record_layout,
+					   const int integral_key );
+
+    // Get the maximum byte size of the derived classes.
+    static std::size_t maxDataByteSize();
+
+    // Get the maximum byte size of the derived classes from the registry.
+    static std::size_t maxDataByteSize( std::true_type );
+
+    // Get the maximum byte size of the derived classes from the policy.
+    static std::size_t maxDataByteSize( std::false_type );
+
+    // Get the byte size of a derived class.
+    static std::size_t derivedClassByteSize( const int integral_key );
+
+    // Get the byte size of a derived class from the registry table.
+    static std::size_t registryByteSize( const int integral_key,
+					 std::true_type );
+
+    // Get the byte size of a derived class without a registry.
+    static std::size_t registryByteSize( const int integral_key,
+					 std::false_type );
+
+    // Get the byte size of a derived class from the policy.
+    static std::size_t derivedClassByteSize( const int integral_key,
+					     std::true_type );
+
+    // Get the byte size of a derived class as the maximum byte size.
+    static std::size_t derivedClassByteSize( const int integral_key,
+					     std::false_type );
+
+    // Get the byte size of the data size written in a record.
+    static std::size_t recordSizeByteSize( const Format record_layout );
+
+    // Get the byte size of a fixed stride record.
+    static std::size_t fixedStrideByteSize( const std::size_t key_size );
+
+    // Get the byte size of the data of an object in a fixed stride record.
+    static std::size_t fixedStrideDataByteSize( const T& object,
+						const int integral_key );
+
+    // Get the byte size of the data of an object.
+    static std::size_t objectDataByteSize( const T& object,
+					   const int integral_key );
+
+    // Get the byte size of the data of an object from the policy.
+    static std::size_t objectDataByteSize( const T& object,
+					   const int integral_key,
+					   std::true_type );
+
+    // Get the byte size of the data of an object as the byte size of its
+    // derived class.
+    static std::size_t objectDataByteSize( const T& object,
+					   const int integral_key,
+					   std::false_type );
+
+    // Write the data size of a record.
+    static void packDataByteSize( const std::size_t data_size,
+				  const std::size_t size_size,
+				  char size_buffer[] );
+
+    // Read the data size of a record.
+    static std::size_t unpackDataByteSize( const char size_buffer[],
+					   const std::size_t size_size,
+					   const Format record_layout,
+					   const int integral_key );
+
+    // Make an object hold an object of the derived class for an integral
+    // key.
+    static void buildObject( AbstractBuilder<T>& builder, 
+			     const int integral_key,
+			     T& object );
+
+    // Index the records of a layout in an indirect char buffer.
+    static void indexRecords( const Format record_layout,
+			      const std::size_t key_size,
+			      const Ordinal bytes, 
+			      const char charBuffer[], 
+			      const Ordinal count,
+			      Teuchos::Array<int>& keys,
+			      Teuchos::Array<std::size_t>& offsets );
+
+    // Serialize to a fixed stride indirect char buffer.
+    static void serializeFixedStride( const std::size_t key_size,
+                                      const Ordinal count, 
+				      const T buffer[], 
+				      const Ordinal bytes, 
+				      char charBuffer[] );
+
+    // Deserialize from a fixed stride indirect char buffer.
+    static void deserializeFixedStride( const std::size_t key_size,
+                                        const Ordinal bytes, 
+					const char charBuffer[], 
+					const Ordinal count, 
+					T buffer[] );
+
+    // Make an object hold a new object of a derived class from the registry
+    // table.
+    static void createObject( AbstractBuilder<T>& builder,
+			      const int integral_key,
+			      T& object,
+			      std::true_type );
+
+    // Make an object hold a new object of a derived class from the builder
+    // factory.
+    static void createObject( AbstractBuilder<T>& builder,
+			      const int integral_key,
+			      T& object,
+			      std::false_type );
+
+    // Check if a replaced object can go back to the pool from the policy.
+    static bool objectPoolable( const T& object, std::true_type );
+
+    // Replaced objects may be shared without the policy so they are dropped.
+    static bool objectPoolable( const T& object, std::false_type );
+
+    // Deserialize from an indirect char buffer with the records grouped by
+    // derived class.
+    static void deserializeGrouped( const Format record_layout,
+				    const std::size_t key_size,
+				    const Ordinal bytes, 
+				    const char charBuffer[], 
+				    const Ordinal count, 
+				    T buffer[] );
+
+    // Serialize to a compact indirect char buffer.
+    static void serializeCompact( const std::size_t key_size,
+                                  const Ordinal count, 
+				  const T buffer[], 
+				  const Ordinal bytes, 
+				  char charBuffer[] );
+
+    // Deserialize from a compact indirect char buffer.
+    static void deserializeCompact( const std::size_t key_size,
+                                    const Ordinal bytes, 
+				    const char charBuffer[], 
+				    const Ordinal count, 
+				    T buffer[] );
+
+    // Serialize to a run length indirect char buffer.
+    static void serializeRunLength( const std::size_t key_size,
+                                    const Ordinal count, 
+				    const T buffer[], 
+				    const Ordinal bytes, 
+				    char charBuffer[] );
+
+    // Deserialize from a run length indirect char buffer.
+    static void deserializeRunLength( const std::size_t key_size,
+                                      const Ordinal bytes, 
+				      const char charBuffer[], 
+				      const Ordinal count, 
+				      T buffer[] );
+
+    // Get the integral key of a batch of objects for the homogeneous format.
+    static int homogeneousKey( const AbstractBuilder<T>& builder,
+			       const Ordinal count, 
+			       const T buffer[] );
+
+    // Serialize to a homogeneous indirect char buffer.
+    static void serializeHomogeneous( const std::size_t key_size,
+                                      const Ordinal count, 
+				      const T buffer[], 
+				      const Ordinal bytes, 
+				      char charBuffer[] );
+
+    // Deserialize from a homogeneous indirect char buffer.
+    static void deserializeHomogeneous( const std::size_t key_size,
+                                        const Ordinal bytes, 
+					const char charBuffer[], 
+					const Ordinal count, 
+					T buffer[] );
+
+    // Copy a homogeneous batch of objects to a buffer as one block.
+    static bool packBitwise( const Ordinal count, 
+			     const T buffer[], 
+			     const std::size_t data_size,
+			     char charBuffer[],
+			     std::true_type );
+
+    // Objects that are not trivially copyable are never copied as a block.
+    static bool packBitwise( const Ordinal count, 
+			     const T buffer[], 
+			     const std::size_t data_size,
+			     char charBuffer[],
+			     std::false_type );
+
+    // Copy a homogeneous batch of objects from a buffer as one block.
+    static bool unpackBitwise( const Ordinal count, 
+			       const char charBuffer[], 
+			       const std::size_t data_size,
+			       T buffer[],
+			       std::true_type );
+
+    // Objects that are not trivially copyable are never copied as a block.
+    static bool unpackBitwise( const Ordinal count, 
+			       const char charBuffer[], 
+			       const std::size_t data_size,
+			       T buffer[],
+			       std::false_type );
+
+    // Serialize to an indirect char buffer in parallel.
+    static void serializeParallel( const Format record_layout,
+				   const std::size_t key_size,
+				   const Ordinal count, 
+				   const T buffer[], 
+				   const Ordinal bytes, 
+				   char charBuffer[] );
+
+    // Deserialize from an indirect char buffer in parallel.
+    static void deserializeParallel( const Format record_layout,
+				     const std::size_t key_size,
+				     const Ordinal bytes, 
+				     const char charBuffer[], 
+				     const Ordinal count, 
+				     T buffer[] );
+
+    // Check if an object changed since a version and update the version.
+    static bool objectChanged( const T& object, 
+			       std::size_t& version,
+			       std::true_type );
+
+    // Without object versions every object has changed.
+    static bool objectChanged( const T& object, 
+			       std::size_t& version,
+			       std::false_type );
+
+  private:
+
+    // Wire format.
+    static Format b_format;
+
+    // Grouped deserialization.
+    static bool b_grouped;
+
+    // In-place deserialization.
+    static bool b_in_place;
+
+    // Parallel packing.
+    static bool b_parallel;
+
+    // Narrow integral keys.
+    static bool b_narrow_keys;
 };
 
 //---------------------------------------------------------------------------//
@@ -42,7 +42,11 @@
 #define Bricks_ABSTRACTSERIALIZER_IMPL_HPP
 
 #include <string>
+#include <cstring>
+#include <algorithm>
+#include <limits>
 
+#include "Bricks_config.hpp"
 #include "Bricks_DBC.hpp"
 #include "Bricks_AbstractBuilder.hpp"
 #include <Teuchos_DefaultComm.hpp>
@@ -60,100 +64,2084 @@ template<class Ordinal, class T>
 const bool AbstractSerializer<Ordinal,T>::supportsDirectSerialization = false;
 
 //---------------------------------------------------------------------------//
-// Return the number of bytes for count objects.
+//! The fixed stride format is the default.
+template<class Ordinal, class T>
+typename AbstractSerializer<Ordinal,T>::Format 
+AbstractSerializer<Ordinal,T>::b_format = 
+    AbstractSerializer<Ordinal,T>::FIXED_STRIDE;
+
+//---------------------------------------------------------------------------//
+//! Records are deserialized in order by default.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::b_grouped = false;
+
+//---------------------------------------------------------------------------//
+//! Objects are always rebuilt by default.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::b_in_place = false;
+
+//---------------------------------------------------------------------------//
+//! Records are packed on one thread by default.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::b_parallel = false;
+
+//---------------------------------------------------------------------------//
+//! Integral keys are written as an int by default.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::b_narrow_keys = false;
+
+//---------------------------------------------------------------------------//
+// Set the wire format.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::setFormat( const Format format )
+{
+    b_format = format;
+}
+
+//---------------------------------------------------------------------------//
+// Get the wire format.
+template<class Ordinal, class T>
+typename AbstractSerializer<Ordinal,T>::Format 
+AbstractSerializer<Ordinal,T>::format()
+{
+    return b_format;
+}
+
+//---------------------------------------------------------------------------//
+// Set whether records are grouped by derived class for deserialization.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::setGroupedDeserialization( 
+    const bool grouped )
+{
+    b_grouped = grouped;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether records are grouped by derived class for deserialization.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::groupedDeserialization()
+{
+    return b_grouped;
+}
+
+//---------------------------------------------------------------------------//
+// Get the layout of the records. The homogeneous format falls back to the
+// compact format if objects do not have the byte size of their derived class.
+template<class Ordinal, class T>
+typename AbstractSerializer<Ordinal,T>::Format 
+AbstractSerializer<Ordinal,T>::layout()
+{
+    if ( HOMOGENEOUS == b_format && HasObjectByteSize<ASOP>::value )
+    {
+	return COMPACT;
+    }
+    return b_format;
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the header of a buffer in the wire format. The header
+// is the format tag of the record layout and the byte size of the integral
+// keys.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::headerByteSize()
+{
+    return 2 * sizeof(unsigned char);
+}
+
+//---------------------------------------------------------------------------//
+// Write the header of a buffer in the wire format.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::packHeader( const Format record_layout,
+						const std::size_t key_size,
+						char charBuffer[] )
+{
+    unsigned char format_tag = record_layout;
+    std::memcpy( &charBuffer[0], &format_tag, sizeof(unsigned char) );
+    packKeyByteSize( key_size, &charBuffer[sizeof(unsigned char)] );
+}
+
+//---------------------------------------------------------------------------//
+// Get the record layout of an indirect char buffer in the wire format from
+// its header. Buffers are always read with the layout they were written with.
+template<class Ordinal, class T>
+typename AbstractSerializer<Ordinal,T>::Format 
+AbstractSerializer<Ordinal,T>::packedFormat( const char charBuffer[] )
+{
+    unsigned char format_tag = 0;
+    std::memcpy( &format_tag, &charBuffer[0], sizeof(unsigned char) );
+    Bricks_INSIST( format_tag <= RUN_LENGTH );
+    return static_cast<Format>( format_tag );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the integral keys of an indirect char buffer in the
+// wire format from its header. Keys are always read with the width they were
+// written with.
+template<class Ordinal, class T>
+std::size_t 
+AbstractSerializer<Ordinal,T>::packedKeyByteSize( const char charBuffer[] )
+{
+    return unpackKeyByteSize( &charBuffer[sizeof(unsigned char)] );
+}
+
+//---------------------------------------------------------------------------//
+// Write the byte size of the integral keys of a buffer.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::packKeyByteSize( const std::size_t key_size,
+						     char buffer[] )
+{
+    unsigned char key_tag = key_size;
+    std::memcpy( buffer, &key_tag, sizeof(unsigned char) );
+}
+
+//---------------------------------------------------------------------------//
+// Read the byte size of the integral keys of a buffer.
+template<class Ordinal, class T>
+std::size_t 
+AbstractSerializer<Ordinal,T>::unpackKeyByteSize( const char buffer[] )
+{
+    unsigned char key_tag = 0;
+    std::memcpy( &key_tag, buffer, sizeof(unsigned char) );
+    Bricks_INSIST( sizeof(signed char) == key_tag || 
+		   sizeof(short) == key_tag || 
+		   sizeof(int) == key_tag );
+    return key_tag;
+}
+
+//---------------------------------------------------------------------------//
+// Set whether objects that already have the derived class of a record are
+// deserialized in place.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::setInPlaceDeserialization( 
+    const bool in_place )
+{
+    b_in_place = in_place;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether objects that already have the derived class of a record are
+// deserialized in place.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::inPlaceDeserialization()
+{
+    return b_in_place;
+}
+
+//---------------------------------------------------------------------------//
+// Set whether records are packed and unpacked in parallel.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::setParallelPacking( const bool parallel )
+{
+    b_parallel = parallel;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether records are packed and unpacked in parallel.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::parallelPacking()
+{
+    return b_parallel;
+}
+
+//---------------------------------------------------------------------------//
+// Set whether integral keys are written with the smallest integral type that
+// holds them.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::setNarrowKeys( const bool narrow_keys )
+{
+    b_narrow_keys = narrow_keys;
+}
+
+//---------------------------------------------------------------------------//
+// Get whether integral keys are written with the smallest integral type that
+// holds them.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::narrowKeys()
+{
+    return b_narrow_keys;
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of bytes for count objects. The byte size only depends on
+// the number of objects as Teuchos sizes the buffer on every process. The
+// buffer has no header so integral keys are always written as an int.
 template<class Ordinal, class T>
 Ordinal AbstractSerializer<Ordinal,T>::fromCountToIndirectBytes( 
-    const Ordinal count, const T buffer[])
+    const Ordinal count, const T[] )
+{
+    return count * fixedStrideByteSize( sizeof(int) );
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to an indirect char buffer. The records always have a fixed
+// stride.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serialize( const Ordinal count, 
+					       const T buffer[], 
+					       const Ordinal bytes, 
+					       char charBuffer[] )
+{
+    if ( b_parallel )
+    {
+	serializeParallel( FIXED_STRIDE, sizeof(int), 
+			   count, buffer, bytes, charBuffer );
+	return;
+    }
+    serializeFixedStride( sizeof(int), count, buffer, bytes, charBuffer );
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of objects for bytes of storage.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::fromIndirectBytesToCount( 
+    const Ordinal bytes, const char[] )
+{
+    return bytes / fixedStrideByteSize( sizeof(int) );
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from an indirect char buffer. The records always have a fixed
+// stride.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserialize( const Ordinal bytes, 
+						 const char charBuffer[], 
+						 const Ordinal count, 
+						 T buffer[] )
+{
+    if ( b_parallel )
+    {
+	deserializeParallel( FIXED_STRIDE, sizeof(int), 
+			     bytes, charBuffer, count, buffer );
+	return;
+    }
+
+    if ( b_grouped )
+    {
+	deserializeGrouped( FIXED_STRIDE, sizeof(int), 
+			    bytes, charBuffer, count, buffer );
+	return;
+    }
+
+    deserializeFixedStride( sizeof(int), bytes, charBuffer, count, buffer );
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of bytes for count objects in the wire format.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::fromCountToPackedBytes( 
+    const Ordinal count, const T buffer[] )
+{
+    return headerByteSize() + 
+	countToBytes( layout(), keyByteSize(), count, buffer );
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to an indirect char buffer in the wire format.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializePacked( const Ordinal count, 
+						     const T buffer[], 
+						     const Ordinal bytes, 
+						     char charBuffer[] )
+{
+    Bricks_REQUIRE( bytes >= Ordinal(headerByteSize()) );
+    Format record_layout = layout();
+    std::size_t key_size = keyByteSize();
+    packHeader( record_layout, key_size, charBuffer );
+    Ordinal record_bytes = bytes - headerByteSize();
+    char* records = &charBuffer[0] + headerByteSize();
+
+    if ( HOMOGENEOUS == record_layout )
+    {
+	serializeHomogeneous( key_size, count, buffer, record_bytes, records );
+	return;
+    }
+
+    if ( b_parallel )
+    {
+	serializeParallel( record_layout, key_size, 
+			   count, buffer, record_bytes, records );
+	return;
+    }
+
+    if ( RUN_LENGTH == record_layout )
+    {
+	serializeRunLength( key_size, count, buffer, record_bytes, records );
+	return;
+    }
+
+    if ( COMPACT == record_layout )
+    {
+	serializeCompact( key_size, count, buffer, record_bytes, records );
+	return;
+    }
+
+    serializeFixedStride( key_size, count, buffer, record_bytes, records );
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of objects in an indirect char buffer in the wire
+// format.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::fromPackedBytesToCount( 
+    const Ordinal bytes, const char charBuffer[] )
+{
+    Bricks_REQUIRE( bytes >= Ordinal(headerByteSize()) );
+    return bytesToCount( packedFormat(charBuffer),
+			 packedKeyByteSize(charBuffer),
+			 bytes - headerByteSize(), 
+			 &charBuffer[0] + headerByteSize() );
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from an indirect char buffer in the wire format.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializePacked( const Ordinal bytes, 
+						       const char charBuffer[], 
+						       const Ordinal count, 
+						       T buffer[] )
+{
+    Bricks_REQUIRE( bytes >= Ordinal(headerByteSize()) );
+    Format record_layout = packedFormat( charBuffer );
+    std::size_t key_size = packedKeyByteSize( charBuffer );
+    Ordinal record_bytes = bytes - headerByteSize();
+    const char* records = &charBuffer[0] + headerByteSize();
+
+    if ( HOMOGENEOUS == record_layout )
+    {
+	deserializeHomogeneous( key_size, record_bytes, records, count, buffer );
+	return;
+    }
+
+    if ( b_parallel )
+    {
+	deserializeParallel( record_layout, key_size, 
+			     record_bytes, records, count, buffer );
+	return;
+    }
+
+    if ( b_grouped )
+    {
+	deserializeGrouped( record_layout, key_size, 
+			    record_bytes, records, count, buffer );
+	return;
+    }
+
+    if ( COMPACT == record_layout )
+    {
+	deserializeCompact( key_size, record_bytes, records, count, buffer );
+	return;
+    }
+
+    if ( RUN_LENGTH == record_layout )
+    {
+	deserializeRunLength( key_size, record_bytes, records, count, buffer );
+	return;
+    }
+
+    deserializeFixedStride( key_size, record_bytes, records, count, buffer );
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to a sequence of indirect char buffers of bounded size.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializeChunked( 
+    const std::size_t count,
+    const T buffer[],
+    const std::size_t chunk_bytes,
+    const ChunkConsumer& consumer )
+{
+    Bricks_REQUIRE( chunk_bytes <= 
+		    std::size_t(std::numeric_limits<Ordinal>::max()) );
+
+    // Every chunk has the header of the format. The records of a
+    // homogeneous chunk take at most their byte size in the compact format.
+    std::size_t header_bytes = fromCountToPackedBytes( 0, buffer );
+    Format record_layout = ( HOMOGENEOUS == layout() ) ? COMPACT : layout();
+    std::size_t key_size = keyByteSize();
+    std::size_t record_header_bytes = 
+	countToBytes( record_layout, key_size, 0, buffer );
+    Teuchos::Array<char> chunk;
+    chunk.reserve( chunk_bytes );
+
+    // Add whole records to the chunk until the next one does not fit and
+    // then give the chunk to the consumer.
+    std::size_t begin = 0;
+    std::size_t bytes = header_bytes;
+    std::size_t record_bytes = 0;
+    for ( std::size_t i = 0; i <= count; ++i )
+    {
+	record_bytes = ( i < count )
+		       ? countToBytes( record_layout, key_size, 1, &buffer[i] ) - 
+			 record_header_bytes
+		       : 0;
+	Bricks_REQUIRE( header_bytes + record_bytes <= chunk_bytes );
+
+	if ( i == count || bytes + record_bytes > chunk_bytes )
+	{
+	    if ( i > begin )
+	    {
+		// Records may share a run header or a homogeneous key so the
+		// chunk can be smaller than the sum of its records.
+		bytes = fromCountToPackedBytes( i - begin, &buffer[begin] );
+		chunk.resize( bytes );
+		serializePacked( i - begin, &buffer[begin], bytes, chunk.getRawPtr() );
+		consumer( chunk() );
+	    }
+	    begin = i;
+	    bytes = header_bytes;
+	}
+	bytes += record_bytes;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize one chunk of a chunked serialization. Return the number of
+// objects deserialized into the front of the buffer.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::deserializeChunk( 
+    const Teuchos::ArrayView<const char>& chunk, T buffer[] )
+{
+    Ordinal count = fromPackedBytesToCount( chunk.size(), chunk.getRawPtr() );
+    deserializePacked( chunk.size(), chunk.getRawPtr(), count, buffer );
+    return count;
+}
+
+//---------------------------------------------------------------------------//
+// Get the version recorded for an object without an implementation. Object
+// versions may not have this value.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::nullVersion()
+{
+    return std::numeric_limits<std::size_t>::max();
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of bytes for the objects that changed since the given
+// versions. The buffer begins with the byte size of the integral keys and the
+// number of records. The byte size must fit in the Ordinal type.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::fromCountToDeltaBytes( 
+    const Ordinal count, 
+    const T buffer[],
+    const Teuchos::ArrayView<const std::size_t>& versions )
+{
+    Bricks_REQUIRE( versions.size() == count );
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+    std::integral_constant<bool,HasObjectVersion<ASOP>::value> has_version;
+
+    std::size_t key_size = keyByteSize();
+    std::size_t size_size = 
+	HasObjectByteSize<ASOP>::value ? sizeof(std::size_t) : 0;
+    std::size_t bytes = sizeof(unsigned char) + sizeof(std::size_t);
+    std::size_t version = 0;
+    int integral_key = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	version = versions[i];
+	if ( objectChanged(buffer[i], version, has_version) )
+	{
+	    bytes += sizeof(std::size_t) + key_size;
+	    integral_key = objectKey( *builder, buffer[i] );
+	    if ( integral_key >= 0 )
+	    {
+		bytes += size_size + objectDataByteSize( buffer[i], integral_key );
+	    }
+	}
+    }
+    Bricks_REQUIRE( bytes <= std::size_t(std::numeric_limits<Ordinal>::max()) );
+    return bytes;
+}
+
+//---------------------------------------------------------------------------//
+// Serialize the objects that changed since the given versions to an indirect
+// char buffer. The versions are updated to the versions sent.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializeDelta( 
+    const Ordinal count, 
+    const T buffer[], 
+    const Teuchos::ArrayView<std::size_t>& versions,
+    const Ordinal bytes, 
+    char charBuffer[] )
+{
+    Bricks_REQUIRE( fromCountToDeltaBytes(count,buffer,versions) == bytes );
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+    std::integral_constant<bool,HasObjectVersion<ASOP>::value> has_version;
+
+    // Write the byte size of the integral keys and leave room for the number
+    // of records.
+    std::size_t key_size = keyByteSize();
+    packKeyByteSize( key_size, &charBuffer[0] );
+    char* num_records_pos = &charBuffer[0] + sizeof(unsigned char);
+    char* buffer_pos = num_records_pos + sizeof(std::size_t);
+
+    // Serialize the changed objects with their index.
+    std::size_t size_size = 
+	HasObjectByteSize<ASOP>::value ? sizeof(std::size_t) : 0;
+    std::size_t num_records = 0;
+    std::size_t index = 0;
+    int integral_key = 0;
+    std::size_t data_size = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	if ( objectChanged(buffer[i], versions[i], has_version) )
+	{
+	    index = i;
+	    std::memcpy( buffer_pos, &index, sizeof(std::size_t) );
+	    buffer_pos += sizeof(std::size_t);
+
+	    integral_key = objectKey( *builder, buffer[i] );
+	    packKey( integral_key, key_size, buffer_pos );
+	    buffer_pos += key_size;
+
+	    if ( integral_key >= 0 )
+	    {
+		data_size = objectDataByteSize( buffer[i], integral_key );
+		packDataByteSize( data_size, size_size, buffer_pos );
+		buffer_pos += size_size;
+		ASOP::serialize( 
+		    buffer[i], Teuchos::ArrayView<char>(buffer_pos,data_size) );
+		buffer_pos += data_size;
+	    }
+
+	    ++num_records;
+	}
+    }
+    std::memcpy( num_records_pos, &num_records, sizeof(std::size_t) );
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Patch objects with the changed objects in an indirect char buffer. Objects
+// that keep their derived class are deserialized in place.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeDelta( 
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
 {
-    return count * ( sizeof(int) + ASOP::maxByteSize() );
+    Bricks_REQUIRE( 
+	bytes >= Ordinal(sizeof(unsigned char) + sizeof(std::size_t)) );
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Get the byte size of the integral keys and the number of records.
+    const char* buffer_pos = &charBuffer[0];
+    std::size_t key_size = unpackKeyByteSize( buffer_pos );
+    buffer_pos += sizeof(unsigned char);
+    std::size_t num_records = 0;
+    std::memcpy( &num_records, buffer_pos, sizeof(std::size_t) );
+    buffer_pos += sizeof(std::size_t);
+
+    // Patch the objects.
+    std::size_t size_size = 
+	HasObjectByteSize<ASOP>::value ? sizeof(std::size_t) : 0;
+    std::size_t index = 0;
+    int integral_key = 0;
+    std::size_t data_size = 0;
+    for ( std::size_t n = 0; n < num_records; ++n )
+    {
+	std::memcpy( &index, buffer_pos, sizeof(std::size_t) );
+	buffer_pos += sizeof(std::size_t);
+	Bricks_CHECK( index < std::size_t(count) );
+
+	integral_key = unpackKey( buffer_pos, key_size );
+	buffer_pos += key_size;
+
+	// Objects that change derived class are rebuilt.
+	if ( integral_key < 0 || 
+	     objectKey(*builder,buffer[index]) != integral_key )
+	{
+	    buildObject( *builder, integral_key, buffer[index] );
+	}
+
+	if ( integral_key >= 0 )
+	{
+	    data_size = ( size_size > 0 )
+			? unpackDataByteSize( 
+			    buffer_pos, size_size, COMPACT, integral_key )
+			: derivedClassByteSize( integral_key );
+	    buffer_pos += size_size;
+	    ASOP::deserialize( 
+		buffer[index], 
+		Teuchos::ArrayView<const char>(buffer_pos,data_size) );
+	    buffer_pos += data_size;
+	}
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Check if an object changed since a version and update the version.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::objectChanged( const T& object, 
+						   std::size_t& version,
+						   std::true_type )
+{
+    std::size_t current_version = ASOP::objectHasImplementation(object)
+				  ? ASOP::objectVersion( object )
+				  : nullVersion();
+    Bricks_CHECK( !ASOP::objectHasImplementation(object) ||
+		  current_version != nullVersion() );
+    bool changed = ( current_version != version );
+    version = current_version;
+    return changed;
+}
+
+//---------------------------------------------------------------------------//
+// Without object versions every object has changed.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::objectChanged( const T&, 
+						   std::size_t&,
+						   std::false_type )
+{
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Get the integral key of an object. Objects without an implementation get a
+// negative key.
+template<class Ordinal, class T>
+int AbstractSerializer<Ordinal,T>::objectKey( 
+    const AbstractBuilder<T>& builder, const T& object )
+{
+    return ASOP::objectHasImplementation(object)
+	? objectKey( builder, object, 
+		     std::integral_constant<
+			 bool,HasObjectIntegralKey<ABOP>::value>() )
+	: -1;
+}
+
+//---------------------------------------------------------------------------//
+// Get the integral key of an object from the policy.
+template<class Ordinal, class T>
+int AbstractSerializer<Ordinal,T>::objectKey( 
+    const AbstractBuilder<T>& builder, const T& object, std::true_type )
+{
+    Bricks_CHECK( ABOP::objectIntegralKey(object) ==
+		  builder.getIntegralKey(ABOP::objectType(object)) );
+    return ABOP::objectIntegralKey( object );
+}
+
+//---------------------------------------------------------------------------//
+// Get the integral key of an object by the name of its type.
+template<class Ordinal, class T>
+int AbstractSerializer<Ordinal,T>::objectKey( 
+    const AbstractBuilder<T>& builder, const T& object, std::false_type )
+{
+    return builder.getIntegralKey( ABOP::objectType(object) );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of an integral key. Narrow keys use the smallest of a
+// signed char, a short or an int that holds every integral key of the
+// builder and the negative key of objects without an implementation.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::keyByteSize()
+{
+    if ( !b_narrow_keys )
+    {
+	return sizeof(int);
+    }
+
+    int num_keys = ABOP::getBuilder()->numDerivedClasses();
+    if ( num_keys <= int(std::numeric_limits<signed char>::max()) + 1 )
+    {
+	return sizeof(signed char);
+    }
+    if ( num_keys <= int(std::numeric_limits<short>::max()) + 1 )
+    {
+	return sizeof(short);
+    }
+    return sizeof(int);
+}
+
+//---------------------------------------------------------------------------//
+// Write an integral key.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::packKey( const int integral_key, 
+					     const std::size_t key_size,
+					     char key_buffer[] )
+{
+    switch ( key_size )
+    {
+	case sizeof(signed char):
+	{
+	    signed char key = integral_key;
+	    std::memcpy( key_buffer, &key, sizeof(signed char) );
+	    break;
+	}
+	case sizeof(short):
+	{
+	    short key = integral_key;
+	    std::memcpy( key_buffer, &key, sizeof(short) );
+	    break;
+	}
+	default:
+	    std::memcpy( key_buffer, &integral_key, sizeof(int) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Read an integral key.
+template<class Ordinal, class T>
+int AbstractSerializer<Ordinal,T>::unpackKey( const char key_buffer[],
+					      const std::size_t key_size )
+{
+    switch ( key_size )
+    {
+	case sizeof(signed char):
+	{
+	    signed char key = 0;
+	    std::memcpy( &key, key_buffer, sizeof(signed char) );
+	    return key;
+	}
+	case sizeof(short):
+	{
+	    short key = 0;
+	    std::memcpy( &key, key_buffer, sizeof(short) );
+	    return key;
+	}
+	default:
+	{
+	    int key = 0;
+	    std::memcpy( &key, key_buffer, sizeof(int) );
+	    return key;
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of bytes for count objects in the given layout.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::countToBytes( 
+    const Format record_layout, 
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[] )
+{
+    if ( HOMOGENEOUS == record_layout )
+    {
+	Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+	int batch_key = homogeneousKey( *builder, count, buffer );
+	return key_size + 
+	    ( ( batch_key >= 0 )
+	      ? sizeof(std::size_t) + 
+		count * recordDataByteSize( record_layout, batch_key )
+	      : countToBytes( COMPACT, key_size, count, buffer ) );
+    }
+
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    if ( COMPACT == record_layout )
+    {
+	Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+	std::size_t bytes = sizeof(std::size_t) + count * key_size;
+	int integral_key = 0;
+	for ( Ordinal i = 0; i < count; ++i )
+	{
+	    integral_key = objectKey( *builder, buffer[i] );
+	    if ( integral_key >= 0 )
+	    {
+		bytes += size_size + objectDataByteSize( buffer[i], integral_key );
+	    }
+	}
+	return bytes;
+    }
+
+    if ( RUN_LENGTH == record_layout )
+    {
+	Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+	std::size_t bytes = sizeof(std::size_t);
+	int integral_key = 0;
+	int run_key = 0;
+	for ( Ordinal i = 0; i < count; ++i )
+	{
+	    integral_key = objectKey( *builder, buffer[i] );
+	    if ( 0 == i || integral_key != run_key )
+	    {
+		bytes += key_size + sizeof(std::size_t);
+		run_key = integral_key;
+	    }
+	    if ( integral_key >= 0 )
+	    {
+		bytes += size_size + objectDataByteSize( buffer[i], integral_key );
+	    }
+	}
+	return bytes;
+    }
+
+    return count * fixedStrideByteSize( key_size );
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of objects for bytes of storage in the given layout.
+template<class Ordinal, class T>
+Ordinal AbstractSerializer<Ordinal,T>::bytesToCount( 
+    const Format record_layout, 
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[] )
+{
+    if ( FIXED_STRIDE != record_layout )
+    {
+	// Homogeneous buffers begin with the key of the batch.
+	std::size_t offset = 
+	    ( HOMOGENEOUS == record_layout ) ? key_size : 0;
+	Bricks_REQUIRE( bytes >= Ordinal(offset + sizeof(std::size_t)) );
+	std::size_t count = 0;
+	std::memcpy( &count, &charBuffer[offset], sizeof(std::size_t) );
+	return count;
+    }
+
+    return bytes / fixedStrideByteSize( key_size );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data in a record for a derived class.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::recordDataByteSize(
+    const Format record_layout, const int integral_key )
+{
+    return ( FIXED_STRIDE == record_layout ) 
+	? maxDataByteSize()
+	: derivedClassByteSize( integral_key );
+}
+
+//---------------------------------------------------------------------------//
+// Get the maximum byte size of the derived classes.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::maxDataByteSize()
+{
+    return maxDataByteSize( 
+	std::integral_constant<bool,HasRegistryType<ASOP>::value>() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the maximum byte size of the derived classes from the registry.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::maxDataByteSize( std::true_type )
+{
+    return ASOP::registry_type::maxByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Get the maximum byte size of the derived classes from the policy.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::maxDataByteSize( std::false_type )
+{
+    return ASOP::maxByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::derivedClassByteSize(
+    const int integral_key )
+{
+    return registryByteSize( 
+	integral_key, 
+	std::integral_constant<bool,HasRegistryType<ASOP>::value>() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class from the registry table. Integral
+// keys without a registry position are sized as without a registry.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::registryByteSize(
+    const int integral_key, std::true_type )
+{
+    int position = ASOP::registry_type::position( integral_key );
+    return ( position >= 0 ) 
+	? ASOP::registry_type::byteSize( position )
+	: registryByteSize( integral_key, std::false_type() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class without a registry.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::registryByteSize(
+    const int integral_key, std::false_type )
+{
+    return derivedClassByteSize( 
+	integral_key, 
+	std::integral_constant<bool,HasDerivedClassByteSize<ASOP>::value>() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class from the policy.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::derivedClassByteSize(
+    const int integral_key, std::true_type )
+{
+    return ASOP::derivedClassByteSize( integral_key );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a derived class as the maximum byte size.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::derivedClassByteSize(
+    const int, std::false_type )
+{
+    return maxDataByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data size written in a record. Records with data
+// begin with the byte size of their data if the policy gives the byte size of
+// each object. Fixed stride records then hold the data size of every record.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::recordSizeByteSize( const Format )
+{
+    return HasObjectByteSize<ASOP>::value ? sizeof(std::size_t) : 0;
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of a fixed stride record. The stride only depends on the
+// policy so fixed stride buffers are sized from the number of objects.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::fixedStrideByteSize(
+    const std::size_t key_size )
+{
+    return key_size + recordSizeByteSize( FIXED_STRIDE ) + 
+	maxDataByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data of an object in a fixed stride record.
+// Objects fill the maximum byte size unless the record holds their data size.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::fixedStrideDataByteSize(
+    const T& object, const int integral_key )
+{
+    if ( recordSizeByteSize(FIXED_STRIDE) > 0 )
+    {
+	std::size_t data_size = objectDataByteSize( object, integral_key );
+	Bricks_REQUIRE( data_size <= maxDataByteSize() );
+	return data_size;
+    }
+    return maxDataByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data of an object.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::objectDataByteSize(
+    const T& object, const int integral_key )
+{
+    return objectDataByteSize( 
+	object, integral_key,
+	std::integral_constant<bool,HasObjectByteSize<ASOP>::value>() );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data of an object from the policy.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::objectDataByteSize(
+    const T& object, const int, std::true_type )
+{
+    return ASOP::objectByteSize( object );
+}
+
+//---------------------------------------------------------------------------//
+// Get the byte size of the data of an object as the byte size of its derived
+// class.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::objectDataByteSize(
+    const T&, const int integral_key, std::false_type )
+{
+    return derivedClassByteSize( integral_key );
+}
+
+//---------------------------------------------------------------------------//
+// Write the data size of a record. Nothing is written if records do not hold
+// their data size.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::packDataByteSize( 
+    const std::size_t data_size,
+    const std::size_t size_size,
+    char size_buffer[] )
+{
+    if ( size_size > 0 )
+    {
+	std::memcpy( size_buffer, &data_size, sizeof(std::size_t) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Read the data size of a record. Records that do not hold their data size
+// have the data size of their derived class.
+template<class Ordinal, class T>
+std::size_t AbstractSerializer<Ordinal,T>::unpackDataByteSize( 
+    const char size_buffer[],
+    const std::size_t size_size,
+    const Format record_layout,
+    const int integral_key )
+{
+    if ( size_size > 0 )
+    {
+	std::size_t data_size = 0;
+	std::memcpy( &data_size, size_buffer, sizeof(std::size_t) );
+	return data_size;
+    }
+    return recordDataByteSize( record_layout, integral_key );
+}
+
+//---------------------------------------------------------------------------//
+// Make an object hold an object of the derived class for an integral key. A
+// negative key gives a default constructed object. In in-place mode an object
+// that already has the derived class is kept. If the builder pool is on the
+// new object comes from the pool and the object it replaces goes back to the
+// pool unless its implementation is shared with a copy.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::buildObject( AbstractBuilder<T>& builder, 
+						 const int integral_key,
+						 T& object )
+{
+    int old_key = ( b_in_place || builder.pooling() )
+		  ? objectKey( builder, object ) : -1;
+
+    if ( b_in_place && old_key >= 0 && old_key == integral_key )
+    {
+	return;
+    }
+
+    if ( !builder.pooling() )
+    {
+	if ( integral_key < 0 )
+	{
+	    object = T();
+	}
+	else
+	{
+	    createObject( builder, integral_key, object,
+			  std::integral_constant<
+			      bool,HasRegistryType<ASOP>::value>() );
+	}
+    }
+    else
+    {
+	Teuchos::RCP<T> pooled_object = ( integral_key < 0 ) 
+					? Teuchos::rcp( new T() )
+					: builder.acquire( integral_key );
+	std::swap( object, *pooled_object );
+	if ( old_key >= 0 && 
+	     objectPoolable(
+		 *pooled_object,
+		 std::integral_constant<
+		     bool,HasObjectIsShared<ABOP>::value>()) )
+	{
+	    builder.release( old_key, pooled_object );
+	}
+    }
+
+    Bricks_ENSURE( (integral_key >= 0) == 
+		   ASOP::objectHasImplementation(object) );
+}
+
+//---------------------------------------------------------------------------//
+// Make an object hold a new object of a derived class from the registry
+// table. Integral keys without a registry position are built by the builder
+// factory.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::createObject( AbstractBuilder<T>& builder,
+						  const int integral_key,
+						  T& object,
+						  std::true_type )
+{
+    int position = ASOP::registry_type::position( integral_key );
+    if ( position >= 0 )
+    {
+	ASOP::registry_type::create( position, object );
+    }
+    else
+    {
+	createObject( builder, integral_key, object, std::false_type() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Make an object hold a new object of a derived class from the builder
+// factory.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::createObject( AbstractBuilder<T>& builder,
+						  const int integral_key,
+						  T& object,
+						  std::false_type )
+{
+    object = *( builder.create(integral_key) );
+}
+
+//---------------------------------------------------------------------------//
+// Check if a replaced object can go back to the pool from the policy.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::objectPoolable( const T& object,
+						    std::true_type )
+{
+    return !ABOP::objectIsShared( object );
+}
+
+//---------------------------------------------------------------------------//
+// Replaced objects may be shared without the policy so they are dropped.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::objectPoolable( const T&,
+						    std::false_type )
+{
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+// Get the first record in an indirect char buffer.
+template<class Ordinal, class T>
+const char* AbstractSerializer<Ordinal,T>::firstRecord( 
+    const char charBuffer[] )
+{
+    Format record_layout = packedFormat( charBuffer );
+    Bricks_REQUIRE( RUN_LENGTH != record_layout && 
+		    HOMOGENEOUS != record_layout );
+    const char* records = &charBuffer[0] + headerByteSize();
+    return ( COMPACT == record_layout ) 
+	? records + sizeof(std::size_t) : records;
+}
+
+//---------------------------------------------------------------------------//
+// Read the integral key and data of a record and get the next record. The
+// layout and key size are those of the buffer holding the record, not the
+// current settings.
+template<class Ordinal, class T>
+const char* AbstractSerializer<Ordinal,T>::nextRecord( 
+    const Format record_layout,
+    const std::size_t key_size,
+    const char record[], 
+    int& integral_key,
+    const char*& data )
+{
+    Bricks_REQUIRE( RUN_LENGTH != record_layout && 
+		    HOMOGENEOUS != record_layout );
+    integral_key = unpackKey( record, key_size );
+    data = record + key_size;
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    if ( FIXED_STRIDE == record_layout )
+    {
+	return data + size_size + maxDataByteSize();
+    }
+    return ( integral_key >= 0 ) 
+	? data + size_size + 
+	  unpackDataByteSize( data, size_size, record_layout, integral_key )
+	: data;
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize the data of one record into an object. A negative integral key
+// gives a default constructed object. An object that already has the derived
+// class of the record is deserialized in place. The layout is the layout of
+// the buffer holding the record, not the current format setting.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeRecord( 
+    const Format record_layout,
+    const int integral_key,
+    const char data[],
+    T& object )
+{
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+    if ( integral_key < 0 || objectKey(*builder,object) != integral_key )
+    {
+	buildObject( *builder, integral_key, object );
+    }
+    if ( integral_key >= 0 )
+    {
+	std::size_t size_size = recordSizeByteSize( record_layout );
+	ASOP::deserialize( 
+	    object, 
+	    Teuchos::ArrayView<const char>(
+		data + size_size, 
+		unpackDataByteSize(
+		    data, size_size, record_layout, integral_key)) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Index the records in an indirect char buffer. Get the integral key of each
+// record and the offset of its data from the front of the buffer, including
+// the header. The data of records that hold their data size begins with the
+// size.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::indexRecords( 
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    Teuchos::Array<int>& keys,
+    Teuchos::Array<std::size_t>& offsets )
+{
+    Bricks_REQUIRE( bytes >= Ordinal(headerByteSize()) );
+    indexRecords( packedFormat(charBuffer), 
+		  packedKeyByteSize(charBuffer),
+		  bytes - headerByteSize(), 
+		  &charBuffer[0] + headerByteSize(), 
+		  count, keys, offsets );
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	offsets[i] += headerByteSize();
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Index the records of the given layout in an indirect char buffer.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::indexRecords( 
+    const Format record_layout,
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    Teuchos::Array<int>& keys,
+    Teuchos::Array<std::size_t>& offsets )
+{
+    Bricks_REQUIRE( 
+	bytesToCount(record_layout,key_size,bytes,charBuffer) == count );
+    keys.resize( count );
+    offsets.resize( count );
+
+    // Homogeneous records share the key of the batch. Batches that are not
+    // homogeneous hold compact records after the key.
+    if ( HOMOGENEOUS == record_layout )
+    {
+	int batch_key = unpackKey( &charBuffer[0], key_size );
+	if ( batch_key < 0 )
+	{
+	    indexRecords( COMPACT, key_size, 
+			  bytes - key_size, &charBuffer[key_size], 
+			  count, keys, offsets );
+	    for ( Ordinal i = 0; i < count; ++i )
+	    {
+		offsets[i] += key_size;
+	    }
+	    return;
+	}
+	std::size_t data_size = recordDataByteSize( record_layout, batch_key );
+	for ( Ordinal i = 0; i < count; ++i )
+	{
+	    keys[i] = batch_key;
+	    offsets[i] = key_size + sizeof(std::size_t) + i * data_size;
+	}
+	return;
+    }
+
+    // Run length records share the key at the front of their run.
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    if ( RUN_LENGTH == record_layout )
+    {
+	std::size_t offset = sizeof(std::size_t);
+	int run_key = 0;
+	std::size_t run_length = 0;
+	Ordinal i = 0;
+	while ( i < count )
+	{
+	    run_key = unpackKey( &charBuffer[offset], key_size );
+	    offset += key_size;
+	    std::memcpy( &run_length, &charBuffer[offset], sizeof(std::size_t) );
+	    offset += sizeof(std::size_t);
+	    Bricks_CHECK( run_length > 0 );
+	    Bricks_CHECK( i + run_length <= std::size_t(count) );
+	    for ( std::size_t n = 0; n < run_length; ++n, ++i )
+	    {
+		keys[i] = run_key;
+		offsets[i] = offset;
+		if ( run_key >= 0 )
+		{
+		    offset += size_size + unpackDataByteSize( 
+			&charBuffer[offset], size_size, record_layout, run_key );
+		}
+	    }
+	}
+	Bricks_ENSURE( Ordinal(offset) == bytes );
+	return;
+    }
+
+    std::size_t offset = 
+	( COMPACT == record_layout ) ? sizeof(std::size_t) : 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	keys[i] = unpackKey( &charBuffer[offset], key_size );
+	offset += key_size;
+	offsets[i] = offset;
+	if ( COMPACT != record_layout )
+	{
+	    offset += size_size + maxDataByteSize();
+	}
+	else if ( keys[i] >= 0 )
+	{
+	    offset += size_size + unpackDataByteSize( 
+		&charBuffer[offset], size_size, record_layout, keys[i] );
+	}
+    }
+    Bricks_ENSURE( Ordinal(offset) == bytes );
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from an indirect char buffer with the records grouped by
+// derived class.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeGrouped( 
+    const Format record_layout,
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Index the records.
+    Teuchos::Array<int> keys;
+    Teuchos::Array<std::size_t> offsets;
+    indexRecords( record_layout, key_size, bytes, charBuffer, count, keys, offsets );
+
+    // Group the records by integral key with a counting sort. Records for
+    // objects without an implementation go in the first group.
+    int num_groups = 
+	( count > 0 ) ? *std::max_element( keys.begin(), keys.end() ) + 2 : 1;
+    Teuchos::Array<Ordinal> group_offsets( num_groups + 1, 0 );
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	++group_offsets[ keys[i] + 2 ];
+    }
+    for ( int g = 1; g < num_groups + 1; ++g )
+    {
+	group_offsets[g] += group_offsets[g-1];
+    }
+    Teuchos::Array<Ordinal> order( count );
+    Teuchos::Array<Ordinal> group_pos( group_offsets.begin(), 
+				       group_offsets.end() - 1 );
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	order[ group_pos[keys[i]+1]++ ] = i;
+    }
+
+    // Objects without an implementation are default constructed.
+    for ( Ordinal n = group_offsets[0]; n < group_offsets[1]; ++n )
+    {
+	buildObject( *builder, -1, buffer[ order[n] ] );
+    }
+
+    // Create and deserialize the objects of each derived class together.
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    Ordinal i = 0;
+    std::size_t data_size = 0;
+    for ( int integral_key = 0; integral_key < num_groups - 1; ++integral_key )
+    {
+	for ( Ordinal n = group_offsets[integral_key+1]; 
+	      n < group_offsets[integral_key+2]; 
+	      ++n )
+	{
+	    i = order[n];
+	    buildObject( *builder, integral_key, buffer[i] );
+	    data_size = unpackDataByteSize( 
+		&charBuffer[offsets[i]], size_size, record_layout, integral_key );
+	    Teuchos::ArrayView<const char> buffer_view( 
+		&charBuffer[offsets[i]] + size_size, data_size );
+	    ASOP::deserialize( buffer[i], buffer_view );
+	}
+    }
 }
 
 //---------------------------------------------------------------------------//
-// Serialize to an indirect char buffer.
+// Serialize to a fixed stride indirect char buffer.
 template<class Ordinal, class T>
-void AbstractSerializer<Ordinal,T>::serialize( const Ordinal count, 
-					       const T buffer[], 
-					       const Ordinal bytes, 
-					       char charBuffer[] )
+void AbstractSerializer<Ordinal,T>::serializeFixedStride( 
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[], 
+    const Ordinal bytes, 
+    char charBuffer[] )
 {
     // Get the builder for the objects.
     Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
 
     // Serialize the objects.
-    Bricks_REQUIRE( fromCountToIndirectBytes(count,buffer) == bytes );
+    Bricks_REQUIRE( countToBytes(FIXED_STRIDE,key_size,count,buffer) == bytes );
     char* buffer_pos = &charBuffer[0];
+    std::size_t size_size = recordSizeByteSize( FIXED_STRIDE );
+    std::size_t stride = fixedStrideByteSize( key_size );
     int integral_key = 0;
+    std::size_t data_size = 0;
     for ( Ordinal i = 0; i < count; ++i )
     {
 	// Get a view of the buffer.
-	Teuchos::ArrayView<char> buffer_view( 
-	    buffer_pos, sizeof(int) + ASOP::maxByteSize() );
+	Teuchos::ArrayView<char> buffer_view( buffer_pos, stride );
 
 	// Fill the buffer with zeros to start.
 	std::fill( buffer_view.begin(), buffer_view.end(), '0' );
 
 	// Only serialize objects that have an underlying implementation.
-	if ( ASOP::objectHasImplementation(buffer[i]) )
+	// Objects without one get a negative key and no data.
+	integral_key = objectKey( *builder, buffer[i] );
+	packKey( integral_key, key_size, buffer_pos );
+	data_size = ( integral_key >= 0 )
+		    ? fixedStrideDataByteSize( buffer[i], integral_key ) : 0;
+	packDataByteSize( data_size, size_size, buffer_pos + key_size );
+	if ( integral_key >= 0 )
 	{
-	    // Serialize the integral key of the object.
-	    integral_key = builder->getIntegralKey( ABOP::objectType(buffer[i]) );
-	    std::memcpy( buffer_pos, &integral_key, sizeof(int) );
-
-	    // Serialize the object.
 	    ASOP::serialize( 
-		buffer[i], buffer_view(sizeof(int), ASOP::maxByteSize()) );
+		buffer[i], buffer_view(key_size + size_size, data_size) );
 	}
 
 	// Move the front of the buffer forward.
-	buffer_pos += sizeof(int) + ASOP::maxByteSize();
+	buffer_pos += stride;
     }
     Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
 }
 
 //---------------------------------------------------------------------------//
-// Return the number of objects for bytes of storage.
+// Deserialize from a fixed stride indirect char buffer.
 template<class Ordinal, class T>
-Ordinal AbstractSerializer<Ordinal,T>::fromIndirectBytesToCount( 
-    const Ordinal bytes, const char charBuffer[] )
+void AbstractSerializer<Ordinal,T>::deserializeFixedStride( 
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
 {
-    return bytes / ( sizeof(int) + ASOP::maxByteSize() );
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Deserialize the objects.
+    Bricks_REQUIRE( bytesToCount(FIXED_STRIDE,key_size,bytes,charBuffer) == count );
+    char* buffer_pos = const_cast<char*>(&charBuffer[0]);
+    std::size_t size_size = recordSizeByteSize( FIXED_STRIDE );
+    int integral_key = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	// Get the integral key for the object.
+	integral_key = unpackKey( buffer_pos, key_size );
+	buffer_pos += key_size;
+
+	// Get an object of the correct derived class. Objects without an
+	// underlying implementation are default constructed.
+	buildObject( *builder, integral_key, buffer[i] );
+	if ( integral_key < 0 )
+	{
+	    buffer_pos += size_size + maxDataByteSize();
+	    continue;
+	}
+
+	// Deserialize the object.
+	Teuchos::ArrayView<char> buffer_view( 
+	    buffer_pos + size_size,
+	    unpackDataByteSize( 
+		buffer_pos, size_size, FIXED_STRIDE, integral_key ) );
+	ASOP::deserialize( buffer[i], buffer_view );
+
+	// Move the front of the buffer forward.
+	buffer_pos += size_size + maxDataByteSize();
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
 }
 
 //---------------------------------------------------------------------------//
-// Deserialize from an indirect char buffer.
+// Serialize to a compact indirect char buffer.
 template<class Ordinal, class T>
-void AbstractSerializer<Ordinal,T>::deserialize( const Ordinal bytes, 
-						 const char charBuffer[], 
-						 const Ordinal count, 
-						 T buffer[] )
+void AbstractSerializer<Ordinal,T>::serializeCompact( 
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[], 
+    const Ordinal bytes, 
+    char charBuffer[] )
 {
     // Get the builder for the objects.
     Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
 
-    // Deserialize the objects.
-    Bricks_REQUIRE( fromIndirectBytesToCount(bytes,charBuffer) == count );
+    // Serialize the number of objects.
+    Bricks_REQUIRE( countToBytes(COMPACT,key_size,count,buffer) == bytes );
+    char* buffer_pos = &charBuffer[0];
+    std::size_t num_objects = count;
+    std::memcpy( buffer_pos, &num_objects, sizeof(std::size_t) );
+    buffer_pos += sizeof(std::size_t);
+
+    // Serialize the objects.
+    std::size_t size_size = recordSizeByteSize( COMPACT );
+    int integral_key = 0;
+    std::size_t data_size = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	// Objects without an underlying implementation only get a key.
+	integral_key = objectKey( *builder, buffer[i] );
+	packKey( integral_key, key_size, buffer_pos );
+	buffer_pos += key_size;
+
+	// Serialize the object.
+	if ( integral_key >= 0 )
+	{
+	    data_size = objectDataByteSize( buffer[i], integral_key );
+	    packDataByteSize( data_size, size_size, buffer_pos );
+	    buffer_pos += size_size;
+	    ASOP::serialize( 
+		buffer[i], Teuchos::ArrayView<char>(buffer_pos,data_size) );
+	    buffer_pos += data_size;
+	}
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from a compact indirect char buffer.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeCompact( 
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Skip the number of objects.
+    Bricks_REQUIRE( bytesToCount(COMPACT,key_size,bytes,charBuffer) == count );
     char* buffer_pos = const_cast<char*>(&charBuffer[0]);
+    buffer_pos += sizeof(std::size_t);
+
+    // Deserialize the objects.
+    std::size_t size_size = recordSizeByteSize( COMPACT );
     int integral_key = 0;
+    std::size_t data_size = 0;
     for ( Ordinal i = 0; i < count; ++i )
     {
 	// Get the integral key for the object.
-	std::memcpy( &integral_key, buffer_pos, sizeof(int) );
-	buffer_pos += sizeof(int);
+	integral_key = unpackKey( buffer_pos, key_size );
+	buffer_pos += key_size;
 
-	// Create an object of the correct derived class.
-	buffer[i] = *( builder->create(integral_key) );
-	Bricks_CHECK( ASOP::objectHasImplementation(buffer[i]) );
+	// Get an object of the correct derived class. Objects without an
+	// underlying implementation are default constructed.
+	buildObject( *builder, integral_key, buffer[i] );
+	if ( integral_key < 0 )
+	{
+	    continue;
+	}
 
 	// Deserialize the object.
-	Teuchos::ArrayView<char> buffer_view( buffer_pos, ASOP::maxByteSize() );
+	data_size = unpackDataByteSize( 
+	    buffer_pos, size_size, COMPACT, integral_key );
+	buffer_pos += size_size;
+	Teuchos::ArrayView<char> buffer_view( buffer_pos, data_size );
 	ASOP::deserialize( buffer[i], buffer_view );
 
 	// Move the front of the buffer forward.
-	buffer_pos += ASOP::maxByteSize();
+	buffer_pos += data_size;
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to a run length indirect char buffer. A new run starts whenever
+// the integral key changes so batches sorted by derived class have one run
+// per derived class.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializeRunLength( 
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[], 
+    const Ordinal bytes, 
+    char charBuffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Serialize the number of objects.
+    Bricks_REQUIRE( countToBytes(RUN_LENGTH,key_size,count,buffer) == bytes );
+    char* buffer_pos = &charBuffer[0];
+    std::size_t num_objects = count;
+    std::memcpy( buffer_pos, &num_objects, sizeof(std::size_t) );
+    buffer_pos += sizeof(std::size_t);
+
+    // Serialize the runs. The length of a run is written when it ends.
+    std::size_t size_size = recordSizeByteSize( RUN_LENGTH );
+    char* run_length_pos = 0;
+    std::size_t run_length = 0;
+    int run_key = 0;
+    int integral_key = 0;
+    std::size_t data_size = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	integral_key = objectKey( *builder, buffer[i] );
+
+	if ( 0 == i || integral_key != run_key )
+	{
+	    if ( 0 != run_length_pos )
+	    {
+		std::memcpy( run_length_pos, &run_length, sizeof(std::size_t) );
+	    }
+	    packKey( integral_key, key_size, buffer_pos );
+	    buffer_pos += key_size;
+	    run_length_pos = buffer_pos;
+	    buffer_pos += sizeof(std::size_t);
+	    run_key = integral_key;
+	    run_length = 0;
+	}
+
+	// Objects without an underlying implementation have no data.
+	if ( integral_key >= 0 )
+	{
+	    data_size = objectDataByteSize( buffer[i], integral_key );
+	    packDataByteSize( data_size, size_size, buffer_pos );
+	    buffer_pos += size_size;
+	    ASOP::serialize( 
+		buffer[i], Teuchos::ArrayView<char>(buffer_pos,data_size) );
+	    buffer_pos += data_size;
+	}
+	++run_length;
+    }
+    if ( 0 != run_length_pos )
+    {
+	std::memcpy( run_length_pos, &run_length, sizeof(std::size_t) );
     }
     Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
 }
 
+//---------------------------------------------------------------------------//
+// Deserialize from a run length indirect char buffer.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeRunLength( 
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Skip the number of objects.
+    Bricks_REQUIRE( bytesToCount(RUN_LENGTH,key_size,bytes,charBuffer) == count );
+    const char* buffer_pos = &charBuffer[0] + sizeof(std::size_t);
+
+    // Deserialize the objects of each run.
+    std::size_t size_size = recordSizeByteSize( RUN_LENGTH );
+    int integral_key = 0;
+    std::size_t run_length = 0;
+    std::size_t data_size = 0;
+    Ordinal i = 0;
+    while ( i < count )
+    {
+	integral_key = unpackKey( buffer_pos, key_size );
+	buffer_pos += key_size;
+	std::memcpy( &run_length, buffer_pos, sizeof(std::size_t) );
+	buffer_pos += sizeof(std::size_t);
+	Bricks_CHECK( run_length > 0 );
+	Bricks_CHECK( i + run_length <= std::size_t(count) );
+
+	for ( std::size_t n = 0; n < run_length; ++n, ++i )
+	{
+	    buildObject( *builder, integral_key, buffer[i] );
+	    if ( integral_key >= 0 )
+	    {
+		data_size = 
+		    unpackDataByteSize( 
+			buffer_pos, size_size, RUN_LENGTH, integral_key );
+		buffer_pos += size_size;
+		ASOP::deserialize( 
+		    buffer[i], 
+		    Teuchos::ArrayView<const char>(buffer_pos,data_size) );
+		buffer_pos += data_size;
+	    }
+	}
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Get the integral key of a batch of objects for the homogeneous format. A
+// batch of objects that all have an implementation of the same derived class
+// gets the key of that derived class and any other batch gets a negative key.
+template<class Ordinal, class T>
+int AbstractSerializer<Ordinal,T>::homogeneousKey( 
+    const AbstractBuilder<T>& builder, const Ordinal count, const T buffer[] )
+{
+    int batch_key = ( count > 0 ) ? objectKey( builder, buffer[0] ) : -1;
+    for ( Ordinal i = 1; i < count && batch_key >= 0; ++i )
+    {
+	if ( objectKey(builder,buffer[i]) != batch_key )
+	{
+	    batch_key = -1;
+	}
+    }
+    return batch_key;
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to a homogeneous indirect char buffer. The buffer begins with
+// the key of the batch. A homogeneous batch then has the number of objects
+// and the data of every object in one contiguous block. Any other batch has
+// compact records.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializeHomogeneous( 
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[], 
+    const Ordinal bytes, 
+    char charBuffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Write the key of the batch.
+    Bricks_REQUIRE( countToBytes(HOMOGENEOUS,key_size,count,buffer) == bytes );
+    int batch_key = homogeneousKey( *builder, count, buffer );
+    packKey( batch_key, key_size, &charBuffer[0] );
+    if ( batch_key < 0 )
+    {
+	if ( b_parallel )
+	{
+	    serializeParallel( COMPACT, key_size, count, buffer, 
+			       bytes - key_size, &charBuffer[key_size] );
+	}
+	else
+	{
+	    serializeCompact( key_size, count, buffer, 
+			      bytes - key_size, &charBuffer[key_size] );
+	}
+	return;
+    }
+
+    // Write the number of objects.
+    char* buffer_pos = &charBuffer[0] + key_size;
+    std::size_t num_objects = count;
+    std::memcpy( buffer_pos, &num_objects, sizeof(std::size_t) );
+    buffer_pos += sizeof(std::size_t);
+
+    // Copy the objects as one block if the policy allows it and otherwise
+    // serialize each object.
+    std::size_t data_size = recordDataByteSize( HOMOGENEOUS, batch_key );
+    if ( packBitwise(
+	     count, buffer, data_size, buffer_pos,
+	     std::integral_constant<
+		 bool,
+		 std::is_trivially_copyable<T>::value &&
+		 HasBitwiseSerializable<ASOP>::value>()) )
+    {
+	return;
+    }
+#if HAVE_Bricks_OPENMP
+#pragma omp parallel for if(b_parallel)
+#endif
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	ASOP::serialize( 
+	    buffer[i], 
+	    Teuchos::ArrayView<char>(buffer_pos + i*data_size, data_size) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from a homogeneous indirect char buffer.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeHomogeneous( 
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Read the key of the batch.
+    Bricks_REQUIRE( bytesToCount(HOMOGENEOUS,key_size,bytes,charBuffer) == count );
+    int batch_key = unpackKey( &charBuffer[0], key_size );
+    if ( batch_key < 0 )
+    {
+	if ( b_parallel )
+	{
+	    deserializeParallel( COMPACT, key_size, bytes - key_size, 
+				 &charBuffer[key_size], count, buffer );
+	}
+	else if ( b_grouped )
+	{
+	    deserializeGrouped( COMPACT, key_size, bytes - key_size, 
+				&charBuffer[key_size], count, buffer );
+	}
+	else
+	{
+	    deserializeCompact( key_size, bytes - key_size, 
+				&charBuffer[key_size], count, buffer );
+	}
+	return;
+    }
+
+    // Copy the objects as one block if the policy allows it.
+    const char* buffer_pos = &charBuffer[0] + key_size + sizeof(std::size_t);
+    std::size_t data_size = recordDataByteSize( HOMOGENEOUS, batch_key );
+    Bricks_CHECK( &charBuffer[0] + bytes == buffer_pos + count*data_size );
+    if ( unpackBitwise(
+	     count, buffer_pos, data_size, buffer,
+	     std::integral_constant<
+		 bool,
+		 std::is_trivially_copyable<T>::value &&
+		 HasBitwiseSerializable<ASOP>::value>()) )
+    {
+	return;
+    }
+
+    // Every object has the derived class of the batch. Objects are built in
+    // parallel with parallel packing if the builder factories are thread
+    // safe and the builder does not pool objects.
+    bool parallel_build = 
+	b_parallel && builder->threadSafeFactories() && !builder->pooling();
+    if ( !parallel_build )
+    {
+	for ( Ordinal i = 0; i < count; ++i )
+	{
+	    buildObject( *builder, batch_key, buffer[i] );
+	}
+    }
+#if HAVE_Bricks_OPENMP
+#pragma omp parallel for if(b_parallel)
+#endif
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	if ( parallel_build )
+	{
+	    buildObject( *builder, batch_key, buffer[i] );
+	}
+	ASOP::deserialize( 
+	    buffer[i], 
+	    Teuchos::ArrayView<const char>(buffer_pos + i*data_size, data_size) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Copy a homogeneous batch of objects to a buffer as one block if the policy
+// serializes objects as their bytes. Return whether the objects were copied.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::packBitwise( const Ordinal count, 
+						 const T buffer[], 
+						 const std::size_t data_size,
+						 char charBuffer[],
+						 std::true_type )
+{
+    if ( !ASOP::bitwiseSerializable() || sizeof(T) != data_size )
+    {
+	return false;
+    }
+    std::memcpy( charBuffer, buffer, count * sizeof(T) );
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Objects that are not trivially copyable are never copied as a block.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::packBitwise( const Ordinal, 
+						 const T[], 
+						 const std::size_t,
+						 char[],
+						 std::false_type )
+{
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+// Copy a homogeneous batch of objects from a buffer as one block if the
+// policy serializes objects as their bytes. Return whether the objects were
+// copied.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::unpackBitwise( const Ordinal count, 
+						   const char charBuffer[], 
+						   const std::size_t data_size,
+						   T buffer[],
+						   std::true_type )
+{
+    if ( !ASOP::bitwiseSerializable() || sizeof(T) != data_size )
+    {
+	return false;
+    }
+    std::memcpy( buffer, charBuffer, count * sizeof(T) );
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+// Objects that are not trivially copyable are never copied as a block.
+template<class Ordinal, class T>
+bool AbstractSerializer<Ordinal,T>::unpackBitwise( const Ordinal, 
+						   const char[], 
+						   const std::size_t,
+						   T[],
+						   std::false_type )
+{
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to an indirect char buffer in parallel. The record layout is
+// computed on one thread and the objects are then serialized in parallel.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::serializeParallel( 
+    const Format record_layout,
+    const std::size_t key_size,
+    const Ordinal count, 
+    const T buffer[], 
+    const Ordinal bytes, 
+    char charBuffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Write the header and integral keys and compute the offset and byte
+    // size of the data in each record.
+    Bricks_REQUIRE( countToBytes(record_layout,key_size,count,buffer) == bytes );
+    Teuchos::Array<int> keys( count );
+    Teuchos::Array<std::size_t> offsets( count );
+    Teuchos::Array<std::size_t> data_sizes( count );
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    std::size_t offset = 0;
+    if ( COMPACT == record_layout || RUN_LENGTH == record_layout )
+    {
+	std::size_t num_objects = count;
+	std::memcpy( &charBuffer[0], &num_objects, sizeof(std::size_t) );
+	offset += sizeof(std::size_t);
+    }
+    std::size_t run_length_offset = 0;
+    std::size_t run_length = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	keys[i] = objectKey( *builder, buffer[i] );
+	if ( RUN_LENGTH == record_layout )
+	{
+	    // Start a new run when the key changes.
+	    if ( 0 == i || keys[i] != keys[i-1] )
+	    {
+		if ( i > 0 )
+		{
+		    std::memcpy( &charBuffer[run_length_offset], &run_length, 
+				 sizeof(std::size_t) );
+		}
+		packKey( keys[i], key_size, &charBuffer[offset] );
+		offset += key_size;
+		run_length_offset = offset;
+		run_length = 0;
+		offset += sizeof(std::size_t);
+	    }
+	    ++run_length;
+	}
+	else
+	{
+	    packKey( keys[i], key_size, &charBuffer[offset] );
+	    offset += key_size;
+	}
+	if ( FIXED_STRIDE == record_layout )
+	{
+	    data_sizes[i] = ( keys[i] >= 0 ) 
+			    ? fixedStrideDataByteSize( buffer[i], keys[i] ) : 0;
+	    packDataByteSize( data_sizes[i], size_size, &charBuffer[offset] );
+	    offset += size_size;
+	}
+	else if ( keys[i] >= 0 )
+	{
+	    data_sizes[i] = objectDataByteSize( buffer[i], keys[i] );
+	    packDataByteSize( data_sizes[i], size_size, &charBuffer[offset] );
+	    offset += size_size;
+	}
+	else
+	{
+	    data_sizes[i] = 0;
+	}
+	offsets[i] = offset;
+	offset += ( FIXED_STRIDE == record_layout ) 
+		  ? maxDataByteSize() : data_sizes[i];
+    }
+    if ( run_length > 0 )
+    {
+	std::memcpy( &charBuffer[run_length_offset], &run_length, 
+		     sizeof(std::size_t) );
+    }
+    Bricks_CHECK( Ordinal(offset) == bytes );
+
+    // Serialize the objects. Fixed stride records are filled with zeros
+    // first as in the serial format.
+#if HAVE_Bricks_OPENMP
+#pragma omp parallel for
+#endif
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	if ( FIXED_STRIDE == record_layout )
+	{
+	    std::fill( &charBuffer[offsets[i]], 
+		       &charBuffer[offsets[i]] + maxDataByteSize(), '0' );
+	}
+	if ( keys[i] >= 0 )
+	{
+	    Teuchos::ArrayView<char> buffer_view( 
+		&charBuffer[offsets[i]], data_sizes[i] );
+	    ASOP::serialize( buffer[i], buffer_view );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from an indirect char buffer in parallel. The records are
+// indexed on one thread and the objects are then built and deserialized in
+// parallel.
+template<class Ordinal, class T>
+void AbstractSerializer<Ordinal,T>::deserializeParallel( 
+    const Format record_layout,
+    const std::size_t key_size,
+    const Ordinal bytes, 
+    const char charBuffer[], 
+    const Ordinal count, 
+    T buffer[] )
+{
+    // Get the builder for the objects.
+    Teuchos::RCP<AbstractBuilder<T> > builder = ABOP::getBuilder();
+
+    // Index the records.
+    Teuchos::Array<int> keys;
+    Teuchos::Array<std::size_t> offsets;
+    indexRecords( record_layout, key_size, bytes, charBuffer, count, keys, offsets );
+
+    // Get the byte size of each record and move its offset to its data.
+    std::size_t size_size = recordSizeByteSize( record_layout );
+    Teuchos::Array<std::size_t> data_sizes( count, 0 );
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	if ( keys[i] >= 0 )
+	{
+	    data_sizes[i] = 
+		unpackDataByteSize( 
+		    &charBuffer[offsets[i]], size_size, record_layout, keys[i] );
+	    offsets[i] += size_size;
+	}
+    }
+
+    // The objects are built in parallel only if the builder factories are
+    // thread safe. The object pool is not thread safe so pooled objects are
+    // built on one thread.
+    bool parallel_build = 
+	builder->threadSafeFactories() && !builder->pooling();
+    if ( !parallel_build )
+    {
+	for ( Ordinal i = 0; i < count; ++i )
+	{
+	    buildObject( *builder, keys[i], buffer[i] );
+	}
+    }
+
+    // Deserialize the objects.
+#if HAVE_Bricks_OPENMP
+#pragma omp parallel for
+#endif
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	if ( parallel_build )
+	{
+	    buildObject( *builder, keys[i], buffer[i] );
+	}
+	if ( keys[i] >= 0 )
+	{
+	    Teuchos::ArrayView<const char> buffer_view( 
+		&charBuffer[offsets[i]], data_sizes[i] );
+	    ASOP::deserialize( buffer[i], buffer_view );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Bricks
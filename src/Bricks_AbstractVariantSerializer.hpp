@@ -0,0 +1,129 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractVariantSerializer.hpp
+ * \author Stuart R. Slattery
+ * \brief Serializer for abstract object variants.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTVARIANTSERIALIZER_HPP
+#define Bricks_ABSTRACTVARIANTSERIALIZER_HPP
+
+#include <cstddef>
+
+#include "Bricks_AbstractObjectVariant.hpp"
+#include "Bricks_AbstractSerializableObject.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class AbstractVariantSerializer
+  \brief Serializer for arrays of abstract object variants.
+
+  This class mimics the Teuchos indirect serialization traits for arrays of
+  AbstractObjectVariant in the same way AbstractSerializer does for
+  RCP-backed abstract objects. Every record is the registry position of the
+  held derived class as an int followed by the maximum byte size of the
+  registry. The stride is a compile time constant so no builder or byte size
+  lookup is made while packing. Empty variants have a negative position and
+  their data is zero filled.
+
+  The data of an object is written and read through the
+  AbstractSerializableObjectPolicy of the base class. Variants in the target
+  array that already hold the derived class of their record are deserialized
+  in place and the others are rebuilt in their own storage without
+  allocation.
+*/
+//---------------------------------------------------------------------------//
+template<class Ordinal, class Variant>
+class AbstractVariantSerializer
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef Ordinal                                     ordinal_type;
+    typedef Variant                                     variant_type;
+    typedef typename Variant::base_type                 base_type;
+    typedef typename Variant::Registry                  Registry;
+    typedef AbstractSerializableObjectPolicy<base_type> ASOP;
+    //@}
+
+    //! Byte size of a record.
+    static constexpr std::size_t recordByteSize()
+    { return sizeof(int) + Registry::maxByteSize(); }
+
+    //! Direct serialization flag.
+    static const bool supportsDirectSerialization = false;
+
+    // Return the number of bytes for count objects.
+    static Ordinal fromCountToIndirectBytes( const Ordinal count, 
+					     const Variant buffer[] );
+
+    // Serialize to an indirect char buffer.
+    static void serialize( const Ordinal count, 
+			   const Variant buffer[], 
+			   const Ordinal bytes, 
+			   char charBuffer[] );
+
+    // Return the number of objects for bytes of storage.
+    static Ordinal fromIndirectBytesToCount( const Ordinal bytes, 
+					     const char charBuffer[] );
+
+    // Deserialize from an indirect char buffer.
+    static void deserialize( const Ordinal bytes, 
+			     const char charBuffer[], 
+			     const Ordinal count, 
+			     Variant buffer[] );
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_AbstractVariantSerializer_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTVARIANTSERIALIZER_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractVariantSerializer.hpp
+//---------------------------------------------------------------------------//
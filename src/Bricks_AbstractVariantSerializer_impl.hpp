@@ -0,0 +1,158 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_AbstractVariantSerializer_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Serializer for abstract object variants.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ABSTRACTVARIANTSERIALIZER_IMPL_HPP
+#define Bricks_ABSTRACTVARIANTSERIALIZER_IMPL_HPP
+
+#include <algorithm>
+#include <cstring>
+
+#include "Bricks_DBC.hpp"
+
+#include <Teuchos_ArrayView.hpp>
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Direct serialization flag.
+template<class Ordinal, class Variant>
+const bool AbstractVariantSerializer<Ordinal,Variant>::supportsDirectSerialization;
+
+//---------------------------------------------------------------------------//
+// Return the number of bytes for count objects.
+template<class Ordinal, class Variant>
+Ordinal AbstractVariantSerializer<Ordinal,Variant>::fromCountToIndirectBytes( 
+    const Ordinal count, const Variant /*buffer*/[] )
+{
+    return count * recordByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Serialize to an indirect char buffer.
+template<class Ordinal, class Variant>
+void AbstractVariantSerializer<Ordinal,Variant>::serialize( 
+    const Ordinal count, const Variant buffer[], 
+    const Ordinal bytes, char charBuffer[] )
+{
+    Bricks_REQUIRE( fromCountToIndirectBytes(count,buffer) == bytes );
+    char* buffer_pos = &charBuffer[0];
+    int index = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	// Get a view of the buffer.
+	Teuchos::ArrayView<char> buffer_view( buffer_pos, recordByteSize() );
+
+	// Fill the buffer with zeros to start.
+	std::fill( buffer_view.begin(), buffer_view.end(), '\0' );
+
+	// Only serialize variants that hold an object.
+	index = buffer[i].index();
+	std::memcpy( buffer_pos, &index, sizeof(int) );
+	if ( index >= 0 )
+	{
+	    ASOP::serialize( 
+		buffer[i].get(), 
+		buffer_view(sizeof(int), Registry::maxByteSize()) );
+	}
+
+	// Move the front of the buffer forward.
+	buffer_pos += recordByteSize();
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+// Return the number of objects for bytes of storage.
+template<class Ordinal, class Variant>
+Ordinal AbstractVariantSerializer<Ordinal,Variant>::fromIndirectBytesToCount( 
+    const Ordinal bytes, const char /*charBuffer*/[] )
+{
+    Bricks_REQUIRE( 0 == bytes % recordByteSize() );
+    return bytes / recordByteSize();
+}
+
+//---------------------------------------------------------------------------//
+// Deserialize from an indirect char buffer.
+template<class Ordinal, class Variant>
+void AbstractVariantSerializer<Ordinal,Variant>::deserialize( 
+    const Ordinal bytes, const char charBuffer[], 
+    const Ordinal count, Variant buffer[] )
+{
+    Bricks_REQUIRE( fromIndirectBytesToCount(bytes,charBuffer) == count );
+    const char* buffer_pos = &charBuffer[0];
+    int index = 0;
+    for ( Ordinal i = 0; i < count; ++i )
+    {
+	// Rebuild the variant unless it already holds the derived class of
+	// the record.
+	std::memcpy( &index, buffer_pos, sizeof(int) );
+	if ( index < 0 )
+	{
+	    buffer[i].clear();
+	}
+	else
+	{
+	    if ( index != buffer[i].index() )
+	    {
+		buffer[i].emplace( index );
+	    }
+	    ASOP::deserialize( 
+		buffer[i].get(),
+		Teuchos::ArrayView<const char>( 
+		    buffer_pos + sizeof(int), Registry::maxByteSize() ) );
+	}
+
+	// Move the front of the buffer forward.
+	buffer_pos += recordByteSize();
+    }
+    Bricks_ENSURE( &charBuffer[0] + bytes == buffer_pos );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ABSTRACTVARIANTSERIALIZER_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_AbstractVariantSerializer_impl.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,172 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_ArenaAllocator.hpp
+ * \author Stuart R. Slattery
+ * \brief Arena allocator for abstract factories.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ARENAALLOCATOR_HPP
+#define Bricks_ARENAALLOCATOR_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayRCP.hpp>
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+/*!
+  \class ArenaAllocator
+  \brief Pooled arena allocator with a free list for abstract factories.
+
+  The allocator implements the allocator policy of Teuchos::AbstractFactoryStd
+  and can be given to AbstractBuildableObject::setDerivedClassFactory() so the
+  objects of a derived class are built in an arena instead of with a new for
+  every object. Objects are constructed in blocks of storage that are never
+  freed one object at a time. The storage of a destroyed object goes on a
+  free list and is reused by the next allocation, and the arena is reused
+  from the front once all of its objects are destroyed, so long-lived objects
+  do not make the arena grow while short-lived populations come and go. The
+  capacity of the arena is bounded by the largest number of objects alive at
+  once. The blocks of an empty arena are freed in bulk with release(). Copies
+  of the allocator share the arena and objects hold a reference to it.
+
+  The allocator is not thread safe. A builder with a factory that allocates
+  from an arena must not be frozen with thread safe factories as the
+  serializer would then build objects from the arena on several threads.
+
+  Only the objects created by the factory live in the arena. Base classes
+  that are value handles to an implementation, such as a base class holding
+  an RCP to its implementation that the derived class constructor sets, copy
+  the created handle into their own storage when they are built from the
+  builder and the handle in the arena is destroyed right away. The
+  implementation is still allocated by the derived class constructor, so the
+  arena only saves allocations for objects used through the RCP the builder
+  returns.
+*/
+//---------------------------------------------------------------------------//
+template<class T>
+class ArenaAllocator
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef T                                   value_type;
+    typedef Teuchos::RCP<T>                     ptr_t;
+    //@}
+
+    // Constructor.
+    explicit ArenaAllocator( const std::size_t block_size = 1024 );
+
+    // Allocate and default construct an object.
+    const ptr_t allocate() const;
+
+    // Free the blocks of an empty arena.
+    void release() const;
+
+    //! Get the number of objects in the arena.
+    std::size_t numObjects() const
+    { return d_arena->d_num_objects; }
+
+    //! Get the number of objects the blocks of the arena can hold.
+    std::size_t capacity() const
+    { return d_arena->d_blocks.size() * d_arena->d_block_size; }
+
+  private:
+
+    // Storage for one object.
+    typedef typename std::aligned_storage<
+	sizeof(T),std::alignment_of<T>::value>::type Storage;
+
+    // Arena shared by the allocator and its objects.
+    struct Arena
+    {
+	// Blocks of storage.
+	Teuchos::Array<Teuchos::ArrayRCP<Storage> > d_blocks;
+
+	// Number of objects in a block.
+	std::size_t d_block_size;
+
+	// Index of the next free storage.
+	std::size_t d_next;
+
+	// Number of objects in the arena.
+	std::size_t d_num_objects;
+
+	// Storage of destroyed objects below the next free storage. Each
+	// storage is on the list at most once so the list is bounded by the
+	// capacity.
+	Teuchos::Array<Storage*> d_free;
+    };
+
+    // Deallocation policy for objects in the arena.
+    class Deallocator
+    {
+      public:
+	typedef T ptr_t;
+	explicit Deallocator( const Teuchos::RCP<Arena>& arena );
+	void free( T* object );
+      private:
+	Teuchos::RCP<Arena> d_arena;
+    };
+
+  private:
+
+    // Arena.
+    Teuchos::RCP<Arena> d_arena;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "Bricks_ArenaAllocator_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end Bricks_ARENAALLOCATOR_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_ArenaAllocator.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,139 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2014, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the Oak Ridge National Laboratory nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Bricks_ArenaAllocator_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief Arena allocator for abstract factories.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_ARENAALLOCATOR_IMPL_HPP
+#define Bricks_ARENAALLOCATOR_IMPL_HPP
+
+#include <new>
+
+#include "Bricks_DBC.hpp"
+
+namespace Bricks
+{
+//---------------------------------------------------------------------------//
+// Constructor.
+template<class T>
+ArenaAllocator<T>::ArenaAllocator( const std::size_t block_size )
+    : d_arena( Teuchos::rcp(new Arena()) )
+{
+    Bricks_REQUIRE( block_size > 0 );
+    d_arena->d_block_size = block_size;
+    d_arena->d_next = 0;
+    d_arena->d_num_objects = 0;
+}
+
+//---------------------------------------------------------------------------//
+// Allocate and default construct an object. The storage of a destroyed
+// object is reused first. A new block is added when the blocks of the arena
+// are full.
+template<class T>
+const typename ArenaAllocator<T>::ptr_t ArenaAllocator<T>::allocate() const
+{
+    if ( !d_arena->d_free.empty() )
+    {
+	T* object = new ( d_arena->d_free.back() ) T();
+	d_arena->d_free.pop_back();
+	++d_arena->d_num_objects;
+	return Teuchos::rcpWithDealloc( object, Deallocator(d_arena), true );
+    }
+
+    std::size_t block = d_arena->d_next / d_arena->d_block_size;
+    std::size_t slot = d_arena->d_next % d_arena->d_block_size;
+    if ( block == std::size_t(d_arena->d_blocks.size()) )
+    {
+	d_arena->d_blocks.push_back( 
+	    Teuchos::arcp<Storage>(d_arena->d_block_size) );
+    }
+
+    T* object = new ( &d_arena->d_blocks[block][slot] ) T();
+    ++d_arena->d_next;
+    ++d_arena->d_num_objects;
+    return Teuchos::rcpWithDealloc( object, Deallocator(d_arena), true );
+}
+
+//---------------------------------------------------------------------------//
+// Free the blocks of an empty arena at once. The arena grows again from the
+// first allocation after the release.
+template<class T>
+void ArenaAllocator<T>::release() const
+{
+    Bricks_REQUIRE( 0 == d_arena->d_num_objects );
+    d_arena->d_blocks.clear();
+    d_arena->d_free.clear();
+    d_arena->d_next = 0;
+}
+
+//---------------------------------------------------------------------------//
+// Deallocator constructor.
+template<class T>
+ArenaAllocator<T>::Deallocator::Deallocator( 
+    const Teuchos::RCP<Arena>& arena )
+    : d_arena( arena )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+// Destroy an object in the arena. The storage is not freed. It goes on the
+// free list and the arena is reused from the front once it is empty.
+template<class T>
+void ArenaAllocator<T>::Deallocator::free( T* object )
+{
+    Bricks_REQUIRE( d_arena->d_num_objects > 0 );
+    object->~T();
+    --d_arena->d_num_objects;
+    if ( 0 == d_arena->d_num_objects )
+    {
+	d_arena->d_next = 0;
+	d_arena->d_free.clear();
+    }
+    else
+    {
+	d_arena->d_free.push_back( reinterpret_cast<Storage*>(object) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Bricks
+
+#endif // end Bricks_ARENAALLOCATOR_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end Bricks_ArenaAllocator_impl.hpp
+//---------------------------------------------------------------------------//
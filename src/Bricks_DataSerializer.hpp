@@ -42,10 +42,16 @@
 #define Bricks_DATASERIALIZER_HPP
 
 #include <cstring>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+#include <cstdint>
 
 #include "Bricks_DBC.hpp"
 
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayView.hpp>
+#include <Teuchos_ArrayRCP.hpp>
 
 namespace Bricks
 {
@@ -55,6 +61,16 @@ namespace Bricks
  * \class DataSerializer
  * \brief DataSerializer for putting data into a byte stream. Based on Tom Evan's
  * Packer class.
+ *
+ * Data may be packed into a user buffer sized by a first pass in compute
+ * buffer size mode or, in growable buffer mode, into a buffer owned by the
+ * serializer that is grown geometrically as data is packed. The growable mode
+ * produces the final byte stream in a single pass over the data.
+ *
+ * By default values are packed back to back. If an alignment is set, each
+ * value is padded to its natural alignment and each array to at least the
+ * given alignment, measured from the beginning of the stream. The matching
+ * DataDeserializer must use the same alignment.
  */
 class DataSerializer
 {
@@ -76,8 +92,44 @@ class DataSerializer
 	, d_begin( 0 )
 	, d_end( 0 )
 	, d_size_mode( false )
+	, d_growable( false )
+	, d_alignment( 0 )
     { /* ... */ }
 
+    //! Copy constructor. In growable buffer mode the copy owns a copy of the
+    //! buffer and its pointers refer to that copy.
+    DataSerializer( const DataSerializer& rhs )
+	: d_size( rhs.d_size )
+	, d_ptr( rhs.d_ptr )
+	, d_begin( rhs.d_begin )
+	, d_end( rhs.d_end )
+	, d_size_mode( rhs.d_size_mode )
+	, d_growable( rhs.d_growable )
+	, d_owned_buffer( rhs.d_owned_buffer )
+	, d_alignment( rhs.d_alignment )
+    {
+	rebase( rhs );
+    }
+
+    //! Assignment operator. In growable buffer mode the copy owns a copy of
+    //! the buffer and its pointers refer to that copy.
+    DataSerializer& operator=( const DataSerializer& rhs )
+    {
+	if ( this != &rhs )
+	{
+	    d_size = rhs.d_size;
+	    d_ptr = rhs.d_ptr;
+	    d_begin = rhs.d_begin;
+	    d_end = rhs.d_end;
+	    d_size_mode = rhs.d_size_mode;
+	    d_growable = rhs.d_growable;
+	    d_owned_buffer = rhs.d_owned_buffer;
+	    d_alignment = rhs.d_alignment;
+	    rebase( rhs );
+	}
+	return *this;
+    }
+
     //! Destructor.
     ~DataSerializer()
     { /* ... */ }
@@ -87,6 +139,7 @@ class DataSerializer
     {
 	Bricks_REQUIRE( buffer );
 	d_size_mode = false;
+	d_growable = false;
 	d_size = size;
 	d_ptr = buffer;
 	d_begin = buffer;
@@ -98,6 +151,7 @@ class DataSerializer
     {
 	Bricks_REQUIRE( buffer.getRawPtr() );
 	d_size_mode = false;
+	d_growable = false;
 	d_size = buffer.size();
 	d_ptr = buffer.getRawPtr();
 	d_begin = buffer.getRawPtr();
@@ -109,16 +163,52 @@ class DataSerializer
     {
 	d_size = 0;
 	d_size_mode = true;
+	d_growable = false;
+    }
+
+    //! Put into growable buffer mode. The serializer packs into a buffer it
+    //! owns and grows as needed. Any capacity left over from a previous pass
+    //! is reused.
+    void growableBufferMode( const std::size_t initial_capacity = 0 )
+    {
+	d_size_mode = false;
+	d_growable = true;
+	if ( d_owned_buffer.size() < 
+	     static_cast<Teuchos::Ordinal>(initial_capacity) )
+	{
+	    d_owned_buffer.resize( initial_capacity );
+	}
+	d_size = d_owned_buffer.size();
+	d_begin = d_owned_buffer.getRawPtr();
+	d_ptr = d_begin;
+	d_end = d_begin + d_size;
+    }
+
+    //! Set the array alignment in bytes. Zero turns off padding.
+    void setAlignment( const std::size_t alignment )
+    {
+	Bricks_REQUIRE( 0 == (alignment & (alignment-1)) );
+	d_alignment = alignment;
+    }
+
+    //! Get the array alignment in bytes.
+    std::size_t alignment() const
+    {
+	return d_alignment;
     }
 
     //! Pack values into the buffer.
     template<class T>
     inline void pack( const T& data )
     {
+	pad( alignof(T) );
 	if ( d_size_mode )
 	    d_size += sizeof(T);
 	else
 	{
+	    if ( d_growable )
+		reserve( sizeof(T) );
+
 	    Bricks_REQUIRE( d_begin );
 	    Bricks_REQUIRE( d_ptr >= d_begin);
 	    Bricks_REQUIRE( d_ptr + sizeof(T) <= d_end );
@@ -129,6 +219,37 @@ class DataSerializer
 	}
     }
 
+    //! Pack a contiguous array of values into the buffer. The number of
+    //! values is packed first. Trivially copyable values are packed as a
+    //! single block.
+    template<class T>
+    inline void pack( const T* data, const std::size_t count )
+    {
+	pack( count );
+	packBlock( data, count, std::is_trivially_copyable<T>() );
+    }
+
+    //! Pack an array view of values into the buffer.
+    template<class T>
+    inline void pack( const Teuchos::ArrayView<T>& data )
+    {
+	pack( data.getRawPtr(), data.size() );
+    }
+
+    //! Pack an array of values into the buffer.
+    template<class T>
+    inline void pack( const Teuchos::Array<T>& data )
+    {
+	pack( data.getRawPtr(), data.size() );
+    }
+
+    //! Pack a vector of values into the buffer.
+    template<class T>
+    inline void pack( const std::vector<T>& data )
+    {
+	pack( data.data(), data.size() );
+    }
+
     //! Get a pointer to the current position of the data stream.
     const_ptr_type getPtr() const 
     { 
@@ -143,19 +264,122 @@ class DataSerializer
 	return d_begin; 
     }
 
-    //! Get a pointer to the ending position of the data stream.
+    //! Get a pointer to the ending position of the data stream. In growable
+    //! buffer mode this is the end of the packed data.
     const_ptr_type end() const 
     { 
 	Bricks_REQUIRE( !d_size_mode ); 
-	return d_end; 
+	return d_growable ? d_ptr : d_end; 
     }
 
-    //! Get the size of the data stream.
+    //! Get the size of the data stream. In growable buffer mode this is the
+    //! number of bytes packed so far.
     std::size_t size() const 
     { 
-	return d_size; 
+	return d_growable ? static_cast<std::size_t>(d_ptr - d_begin) : d_size;
     }
-    
+
+    //! Get a view of the data packed so far. The view is invalidated by
+    //! further packing in growable buffer mode.
+    Teuchos::ArrayView<data_type> getBufferView() const
+    {
+	Bricks_REQUIRE( !d_size_mode );
+	return Teuchos::ArrayView<data_type>( d_begin, d_ptr - d_begin );
+    }
+
+  private:
+
+    // Pack a block of trivially copyable values with a single copy.
+    template<class T>
+    inline void packBlock( const T* data, const std::size_t count,
+			   std::true_type )
+    {
+	std::size_t bytes = count * sizeof(T);
+	if ( bytes > 0 )
+	    pad( std::max(alignof(T),d_alignment) );
+	if ( d_size_mode )
+	    d_size += bytes;
+	else if ( bytes > 0 )
+	{
+	    if ( d_growable )
+		reserve( bytes );
+
+	    Bricks_REQUIRE( data );
+	    Bricks_REQUIRE( d_begin );
+	    Bricks_REQUIRE( d_ptr >= d_begin);
+	    Bricks_REQUIRE( d_ptr + bytes <= d_end );
+
+	    std::memcpy( d_ptr, data, bytes );
+
+	    d_ptr += bytes;
+	}
+    }
+
+    // Pack a block of values that are not trivially copyable one at a time.
+    template<class T>
+    inline void packBlock( const T* data, const std::size_t count,
+			   std::false_type )
+    {
+	for ( std::size_t n = 0; n < count; ++n )
+	{
+	    pack( data[n] );
+	}
+    }
+
+    // Pad the stream with zeros to the given alignment if padding is on.
+    inline void pad( const std::size_t alignment )
+    {
+	if ( d_alignment > 0 )
+	{
+	    std::size_t offset = d_size_mode ? d_size : d_ptr - d_begin;
+	    std::size_t padding = (alignment - offset % alignment) % alignment;
+	    if ( d_size_mode )
+		d_size += padding;
+	    else if ( padding > 0 )
+	    {
+		if ( d_growable )
+		    reserve( padding );
+
+		Bricks_REQUIRE( d_ptr + padding <= d_end );
+
+		std::memset( d_ptr, 0, padding );
+
+		d_ptr += padding;
+	    }
+	}
+    }
+
+    // Grow the owned buffer geometrically such that the given number of bytes
+    // can be packed at the current position.
+    void reserve( const std::size_t bytes )
+    {
+	Bricks_REQUIRE( d_growable );
+	if ( d_ptr + bytes > d_end )
+	{
+	    std::size_t offset = d_ptr - d_begin;
+	    std::size_t capacity = std::max( 2*d_size, offset + bytes );
+	    d_owned_buffer.resize( capacity );
+	    d_size = capacity;
+	    d_begin = d_owned_buffer.getRawPtr();
+	    d_ptr = d_begin + offset;
+	    d_end = d_begin + d_size;
+	}
+	Bricks_ENSURE( d_ptr + bytes <= d_end );
+    }
+
+    // Point the stream at the owned buffer of this serializer after the
+    // state of another serializer is copied. Streams over a user buffer keep
+    // pointing at that buffer.
+    void rebase( const DataSerializer& rhs )
+    {
+	if ( d_growable )
+	{
+	    d_begin = d_owned_buffer.getRawPtr();
+	    d_ptr = d_begin + ( rhs.d_ptr - rhs.d_begin );
+	    d_end = d_begin + d_size;
+	}
+    }
+
   private:
 
     // Size of buffer.
@@ -172,6 +396,15 @@ class DataSerializer
 
     // Boolean for size mode.
     bool d_size_mode;
+
+    // Boolean for growable buffer mode.
+    bool d_growable;
+
+    // Buffer owned by the serializer in growable buffer mode.
+    Teuchos::Array<data_type> d_owned_buffer;
+
+    // Array alignment. Zero if padding is off.
+    std::size_t d_alignment;
 };
     
 //---------------------------------------------------------------------------//
@@ -179,6 +412,9 @@ class DataSerializer
  * \class DataDeserializer
  * \brief DataDeserializer for pulling data out of a byte stream. Based on Tom
  * Evan's Unpacker class. 
+ *
+ * The alignment must match the one used by the DataSerializer that packed
+ * the stream.
  */
 class DataDeserializer
 {
@@ -199,6 +435,7 @@ class DataDeserializer
 	, d_ptr( 0 )
 	, d_begin( 0 )
 	, d_end( 0 )
+	, d_alignment( 0 )
     { /* ... */ }
 
     //! Destructor.
@@ -225,10 +462,25 @@ class DataDeserializer
 	d_end = d_begin + d_size;
     }
 
-    //! Pack values into the buffer.
+    //! Set the array alignment in bytes. Zero turns off padding.
+    void setAlignment( const std::size_t alignment )
+    {
+	Bricks_REQUIRE( 0 == (alignment & (alignment-1)) );
+	d_alignment = alignment;
+    }
+
+    //! Get the array alignment in bytes.
+    std::size_t alignment() const
+    {
+	return d_alignment;
+    }
+
+    //! Unpack values from the buffer.
     template<class T>
     inline void unpack( T& data )
     {
+	skipPadding( alignof(T) );
+
 	Bricks_REQUIRE( d_begin );
 	Bricks_REQUIRE( d_ptr >= d_begin);
 	Bricks_REQUIRE( d_ptr + sizeof(T) <= d_end );
@@ -238,6 +490,97 @@ class DataDeserializer
 	d_ptr += sizeof(T);
     }
 
+    //! Unpack a contiguous array of values from the buffer. The number of
+    //! values in the buffer must match the given count.
+    template<class T>
+    inline void unpack( T* data, const std::size_t count )
+    {
+	std::size_t packed_count = 0;
+	unpack( packed_count );
+	Bricks_REQUIRE( packed_count == count );
+	unpackBlock( data, count, std::is_trivially_copyable<T>() );
+    }
+
+    //! Unpack values into an array view. The number of values in the buffer
+    //! must match the size of the view.
+    template<class T>
+    inline void unpack( Teuchos::ArrayView<T>& data )
+    {
+	unpack( data.getRawPtr(), data.size() );
+    }
+
+    //! Unpack values into an array view. The number of values in the buffer
+    //! must match the size of the view.
+    template<class T>
+    inline void unpack( const Teuchos::ArrayView<T>& data )
+    {
+	unpack( data.getRawPtr(), data.size() );
+    }
+
+    //! Unpack values into an array. The array is resized to the number of
+    //! values in the buffer.
+    template<class T>
+    inline void unpack( Teuchos::Array<T>& data )
+    {
+	std::size_t packed_count = 0;
+	unpack( packed_count );
+	data.resize( packed_count );
+	unpackBlock( data.getRawPtr(), packed_count, 
+		     std::is_trivially_copyable<T>() );
+    }
+
+    //! Unpack values into a vector. The vector is resized to the number of
+    //! values in the buffer.
+    template<class T>
+    inline void unpack( std::vector<T>& data )
+    {
+	std::size_t packed_count = 0;
+	unpack( packed_count );
+	data.resize( packed_count );
+	unpackBlock( data.data(), packed_count, 
+		     std::is_trivially_copyable<T>() );
+    }
+
+    //! Get a read-only view of a contiguous array of values packed with the
+    //! bulk pack functions. The view points directly into the buffer when the
+    //! values are aligned for T. Misaligned values are copied into storage
+    //! owned by the returned array.
+    template<class T>
+    inline Teuchos::ArrayRCP<const T> view()
+    {
+	static_assert( std::is_trivially_copyable<T>::value,
+		       "Only trivially copyable values can be viewed" );
+
+	std::size_t count = 0;
+	unpack( count );
+	std::size_t bytes = count * sizeof(T);
+	if ( 0 == bytes )
+	{
+	    return Teuchos::ArrayRCP<const T>();
+	}
+	skipPadding( std::max(alignof(T),d_alignment) );
+
+	Bricks_REQUIRE( d_begin );
+	Bricks_REQUIRE( d_ptr >= d_begin);
+	Bricks_REQUIRE( d_ptr + bytes <= d_end );
+
+	Teuchos::ArrayRCP<const T> values;
+	if ( 0 == reinterpret_cast<std::uintptr_t>(d_ptr) % alignof(T) )
+	{
+	    values = Teuchos::arcp( 
+		reinterpret_cast<const T*>(d_ptr), 0, count, false );
+	}
+	else
+	{
+	    Teuchos::ArrayRCP<T> copy = Teuchos::arcp<T>( count );
+	    std::memcpy( copy.getRawPtr(), d_ptr, bytes );
+	    values = copy;
+	}
+
+	d_ptr += bytes;
+	return values;
+    }
+
     //! Get a pointer to the current position of the data stream.
     const_ptr_type getPtr() const 
     { 
@@ -262,6 +605,52 @@ class DataDeserializer
 	return d_size; 
     }
 
+  private:
+
+    // Unpack a block of trivially copyable values with a single copy.
+    template<class T>
+    inline void unpackBlock( T* data, const std::size_t count, 
+			     std::true_type )
+    {
+	std::size_t bytes = count * sizeof(T);
+	if ( bytes > 0 )
+	{
+	    skipPadding( std::max(alignof(T),d_alignment) );
+
+	    Bricks_REQUIRE( data );
+	    Bricks_REQUIRE( d_begin );
+	    Bricks_REQUIRE( d_ptr >= d_begin);
+	    Bricks_REQUIRE( d_ptr + bytes <= d_end );
+
+	    std::memcpy( data, d_ptr, bytes );
+
+	    d_ptr += bytes;
+	}
+    }
+
+    // Unpack a block of values that are not trivially copyable one at a
+    // time.
+    template<class T>
+    inline void unpackBlock( T* data, const std::size_t count, 
+			     std::false_type )
+    {
+	for ( std::size_t n = 0; n < count; ++n )
+	{
+	    unpack( data[n] );
+	}
+    }
+
+    // Skip the padding written for the given alignment if padding is on.
+    inline void skipPadding( const std::size_t alignment )
+    {
+	if ( d_alignment > 0 )
+	{
+	    std::size_t offset = d_ptr - d_begin;
+	    d_ptr += (alignment - offset % alignment) % alignment;
+	    Bricks_ENSURE( d_ptr <= d_end );
+	}
+    }
+
   private:
 
     // Size of buffer.
@@ -275,6 +664,9 @@ class DataDeserializer
 
     // Pointer to the end of the buffer.
     ptr_type d_end;
+
+    // Array alignment. Zero if padding is off.
+    std::size_t d_alignment;
 };
 
 //---------------------------------------------------------------------------//
@@ -78,6 +78,120 @@ TEUCHOS_UNIT_TEST( AbstractBuilder, builder_test )
     int key_2 = builder.getIntegralKey( "two" );
     Teuchos::RCP<BaseClass> base_4 = builder.create( key_2 );
     TEST_EQUALITY( base_4->myNumber(), 2 );
+    // Names that are not registered have no key.
+    TEST_THROW( builder.getIntegralKey("three"), Bricks::Assertion );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractBuilder, pool_test )
+{
+    Bricks::AbstractBuilder<BaseClass> builder;
+    builder.setDerivedClassFactory(
+	Teuchos::abstractFactoryStd<BaseClass,MyNumberIsOne>(), "one" );
+    builder.setDerivedClassFactory(
+	Teuchos::abstractFactoryStd<BaseClass,MyNumberIsTwo>(), "two" );
+    int key_1 = builder.getIntegralKey( "one" );
+    int key_2 = builder.getIntegralKey( "two" );
+
+    // Released objects are dropped when the pool is off.
+    TEST_ASSERT( !builder.pooling() );
+    builder.release( key_1, builder.create(key_1) );
+    TEST_EQUALITY( 0, builder.poolSize(key_1) );
+
+    // Released objects are reused when the pool is on.
+    builder.setPooling( true );
+    TEST_ASSERT( builder.pooling() );
+    Teuchos::RCP<BaseClass> base_1 = builder.acquire( key_1 );
+    TEST_EQUALITY( base_1->myNumber(), 1 );
+    builder.release( key_1, base_1 );
+    TEST_EQUALITY( 1, builder.poolSize(key_1) );
+    TEST_EQUALITY( 0, builder.poolSize(key_2) );
+
+    Teuchos::RCP<BaseClass> base_2 = builder.acquire( key_1 );
+    TEST_EQUALITY( base_1.get(), base_2.get() );
+    TEST_EQUALITY( 0, builder.poolSize(key_1) );
+
+    Teuchos::RCP<BaseClass> base_3 = builder.acquire( key_2 );
+    TEST_EQUALITY( base_3->myNumber(), 2 );
+
+    // Clearing the pool or turning it off empties it.
+    builder.release( key_1, base_2 );
+    builder.release( key_2, base_3 );
+    builder.clearPool();
+    TEST_EQUALITY( 0, builder.poolSize(key_1) );
+    TEST_EQUALITY( 0, builder.poolSize(key_2) );
+    builder.release( key_2, base_3 );
+    builder.setPooling( false );
+    TEST_EQUALITY( 0, builder.poolSize(key_2) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractBuilder, freeze_test )
+{
+    Bricks::AbstractBuilder<BaseClass> builder;
+    builder.setDerivedClassFactory(
+	Teuchos::abstractFactoryStd<BaseClass,MyNumberIsOne>(), "one" );
+    TEST_ASSERT( !builder.isFrozen() );
+
+    // Lookups and creation still work once the builder is frozen.
+    builder.freeze();
+    TEST_ASSERT( builder.isFrozen() );
+    TEST_ASSERT( !builder.threadSafeFactories() );
+    int key_1 = builder.getIntegralKey( "one" );
+    TEST_EQUALITY( builder.create(key_1)->myNumber(), 1 );
+    TEST_EQUALITY( builder.create("one")->myNumber(), 1 );
+
+    // Late registrations are rejected.
+    TEST_THROW( builder.setDerivedClassFactory(
+		    Teuchos::abstractFactoryStd<BaseClass,MyNumberIsTwo>(), 
+		    "two" ),
+		Bricks::Assertion );
+    TEST_EQUALITY( 1, builder.numDerivedClasses() );
+
+    // Factories are only thread safe when declared so.
+    Bricks::AbstractBuilder<BaseClass> thread_safe_builder;
+    thread_safe_builder.freeze( true );
+    TEST_ASSERT( thread_safe_builder.threadSafeFactories() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractBuilder, create_many_test )
+{
+    Bricks::AbstractBuilder<BaseClass> builder;
+    builder.setDerivedClassFactory<MyNumberIsOne>( "one" );
+    builder.setDerivedClassFactory(
+	Teuchos::abstractFactoryStd<BaseClass,MyNumberIsTwo>(), "two" );
+    int key_1 = builder.getIntegralKey( "one" );
+    int key_2 = builder.getIntegralKey( "two" );
+    int num_objects = 10;
+
+    // Classes set by type are created in one contiguous slab.
+    Teuchos::Array<Teuchos::RCP<BaseClass> > ones = 
+	builder.createMany( key_1, num_objects );
+    TEST_EQUALITY( num_objects, ones.size() );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	TEST_EQUALITY( ones[i]->myNumber(), 1 );
+	if ( i > 0 )
+	{
+	    TEST_EQUALITY( dynamic_cast<MyNumberIsOne*>(ones[i-1].get()) + 1,
+			   dynamic_cast<MyNumberIsOne*>(ones[i].get()) );
+	}
+    }
+
+    // A handle keeps the slab alive.
+    Teuchos::RCP<BaseClass> last = ones.back();
+    ones.clear();
+    TEST_EQUALITY( last->myNumber(), 1 );
+
+    // Other classes are created one at a time.
+    Teuchos::Array<Teuchos::RCP<BaseClass> > twos = 
+	builder.createMany( key_2, num_objects );
+    TEST_EQUALITY( num_objects, twos.size() );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	TEST_EQUALITY( twos[i]->myNumber(), 2 );
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,141 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstAbstractDistributor.cpp
+ * \author Stuart Slattery
+ * \brief  Abstract distributor class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+
+#include <Bricks_AbstractDistributor.hpp>
+#include <Bricks_AbstractSerializer.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_SerializationTraits.hpp"
+#include "Teuchos_as.hpp"
+
+#include "tstAbstractObjectFixture.hpp"
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractDistributor, distribute )
+{
+    using namespace Bricks;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+    int right = ( comm_rank + 1 ) % comm_size;
+    int left = ( comm_rank + comm_size - 1 ) % comm_size;
+
+    // Send objects of both derived classes to the right neighbor and one
+    // object without an implementation to this rank. The data of each object
+    // is the rank it came from.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> exports( 5 );
+    Teuchos::Array<int> destinations( 5, right );
+    exports[0] = *( builder->create("one") );
+    exports[1] = *( builder->create("two") );
+    exports[3] = *( builder->create("two") );
+    exports[4] = *( builder->create("one") );
+    for ( int i = 0; i < exports.size(); ++i )
+    {
+	if ( exports[i].isImplNonnull() )
+	{
+	    exports[i].setData( 1.0*comm_rank );
+	}
+    }
+    destinations[2] = comm_rank;
+
+    // Distribute the objects.
+    AbstractDistributor<BaseClass> distributor( comm );
+    Teuchos::Array<BaseClass> imports;
+    distributor.distribute( exports(), destinations(), imports );
+    TEST_EQUALITY( 5, imports.size() );
+
+    // Check the export and import ranks.
+    if ( 1 == comm_size )
+    {
+	TEST_EQUALITY( 1, distributor.exportRanks().size() );
+	TEST_EQUALITY( 5, distributor.exportCounts()[0] );
+	TEST_EQUALITY( 1, distributor.importRanks().size() );
+	TEST_EQUALITY( 5, distributor.importCounts()[0] );
+    }
+    else
+    {
+	TEST_EQUALITY( 2, distributor.exportRanks().size() );
+	TEST_EQUALITY( 2, distributor.importRanks().size() );
+	int first = std::min( comm_rank, left );
+	int second = std::max( comm_rank, left );
+	TEST_EQUALITY( first, distributor.importRanks()[0] );
+	TEST_EQUALITY( second, distributor.importRanks()[1] );
+	TEST_EQUALITY( (first == left) ? 4 : 1, distributor.importCounts()[0] );
+	TEST_EQUALITY( (second == left) ? 4 : 1, distributor.importCounts()[1] );
+    }
+
+    // Check the objects. Imports are ordered by source rank.
+    int num_null = 0;
+    int num_one = 0;
+    int num_two = 0;
+    for ( int i = 0; i < imports.size(); ++i )
+    {
+	if ( !imports[i].isImplNonnull() )
+	{
+	    ++num_null;
+	}
+	else
+	{
+	    TEST_EQUALITY( 1.0*left, imports[i].myData()[0] );
+	    ( 1 == imports[i].myNumber() ) ? ++num_one : ++num_two;
+	}
+    }
+    TEST_EQUALITY( 1, num_null );
+    TEST_EQUALITY( 2, num_one );
+    TEST_EQUALITY( 2, num_two );
+
+    // Distribute the imports back to their source rank.
+    Teuchos::Array<BaseClass> returned;
+    Teuchos::Array<int> sources( imports.size(), left );
+    distributor.distribute( imports(), sources(), returned );
+    TEST_EQUALITY( 5, returned.size() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractDistributor, empty_distribute )
+{
+    using namespace Bricks;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Distribute nothing.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    AbstractDistributor<BaseClass> distributor( comm );
+    Teuchos::Array<BaseClass> exports;
+    Teuchos::Array<int> destinations;
+    Teuchos::Array<BaseClass> imports;
+    distributor.distribute( exports(), destinations(), imports );
+    TEST_EQUALITY( 0, imports.size() );
+    TEST_EQUALITY( 0, distributor.exportRanks().size() );
+    TEST_EQUALITY( 0, distributor.importRanks().size() );
+}
+
+//---------------------------------------------------------------------------//
+// end of tstAbstractDistributor.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,112 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstAbstractLazyArray.cpp
+ * \author Stuart Slattery
+ * \brief  Abstract lazy array class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+
+#include <Bricks_AbstractLazyArray.hpp>
+#include <Bricks_AbstractSerializer.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_SerializationTraits.hpp"
+#include "Teuchos_as.hpp"
+
+#include "tstAbstractObjectFixture.hpp"
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractLazyArray, lazy_array )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Construct an array of base class objects. Leave some without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 9;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	if ( i % 3 != 2 )
+	{
+	    objects[i] = *( builder->create( (i%3) ? "two" : "one" ) );
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // Check both formats.
+    Teuchos::Array<Serializer::Format> formats( 2 );
+    formats[0] = Serializer::FIXED_STRIDE;
+    formats[1] = Serializer::COMPACT;
+    for ( int f = 0; f < formats.size(); ++f )
+    {
+	Serializer::setFormat( formats[f] );
+
+	// Serialize the objects.
+	int bytes = Serializer::fromCountToPackedBytes( 
+	    objects.size(), objects.getRawPtr() );
+	Teuchos::ArrayRCP<char> buffer = Teuchos::arcp<char>( bytes );
+	Serializer::serializePacked( 
+	    objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+	// Create a lazy array over the buffer. Nothing is deserialized.
+	AbstractLazyArray<BaseClass> lazy_array( buffer );
+	TEST_EQUALITY( num_objects, lazy_array.size() );
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    int key = ( i % 3 == 2 ) ? -1 : 
+		      builder->getIntegralKey( (i%3) ? "two" : "one" );
+	    TEST_EQUALITY( key, lazy_array.integralKey(i) );
+	    TEST_ASSERT( !lazy_array.isDeserialized(i) );
+	}
+
+	// Access some of the objects.
+	TEST_EQUALITY( 2, lazy_array[4].myNumber() );
+	TEST_EQUALITY( 4.0, lazy_array[4].myData()[1] );
+	TEST_EQUALITY( 1, lazy_array[6].myNumber() );
+	TEST_EQUALITY( 6.0, lazy_array[6].myData()[0] );
+	TEST_ASSERT( !lazy_array[8].isImplNonnull() );
+
+	// Only the accessed objects were deserialized.
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    TEST_EQUALITY( (4 == i || 6 == i || 8 == i),
+			   lazy_array.isDeserialized(i) );
+	}
+
+	// Accessed objects are kept.
+	lazy_array[4].setData( 5.0 );
+	TEST_EQUALITY( 5.0, lazy_array[4].myData()[0] );
+
+	// The remaining records are read with the format of the buffer even
+	// if the format setting changes.
+	Serializer::setFormat( formats[(f+1) % formats.size()] );
+	TEST_EQUALITY( 1, lazy_array[3].myNumber() );
+	TEST_EQUALITY( 3.0, lazy_array[3].myData()[0] );
+	TEST_EQUALITY( 2, lazy_array[7].myNumber() );
+	TEST_EQUALITY( 7.0, lazy_array[7].myData()[1] );
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+// end of tstAbstractLazyArray.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,345 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstAbstractObjectFixture.hpp
+ * \author Stuart Slattery
+ * \brief  Abstract object hierarchy shared by the serialized container unit
+ *         tests.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef Bricks_TSTABSTRACTOBJECTFIXTURE_HPP
+#define Bricks_TSTABSTRACTOBJECTFIXTURE_HPP
+
+#include <string>
+#include <cstring>
+#include <vector>
+
+#include <Bricks_AbstractSerializableObject.hpp>
+#include <Bricks_AbstractBuilder.hpp>
+#include <Bricks_AbstractBuildableObject.hpp>
+#include <Bricks_AbstractObjectRegistry.hpp>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "Teuchos_Array.hpp"
+
+//---------------------------------------------------------------------------//
+// HELPER CLASSES
+//---------------------------------------------------------------------------//
+
+// Base class implementation.
+class BaseClassImpl
+{
+  public:
+
+    BaseClassImpl() { /* ... */ }
+    virtual ~BaseClassImpl() { /* ... */ }
+
+    virtual int myNumber() = 0;
+    virtual Teuchos::Array<double> myData() = 0;
+    virtual void setData( const double data ) = 0;
+        
+    virtual std::string objectType() const = 0;
+    virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const = 0;
+    virtual void deserialize( const Teuchos::ArrayView<const char>& buffer ) = 0;
+};
+
+// Base class interface.
+class BaseClass : public Bricks::AbstractBuildableObject<BaseClass>
+		, public Bricks::AbstractSerializableObject<BaseClass>
+{
+  public:
+
+    BaseClass() { /* ... */ }
+    virtual ~BaseClass() { /* ... */ }
+
+    virtual int myNumber() { return b_impl->myNumber(); }
+    virtual Teuchos::Array<double> myData() 
+    { return b_impl->myData(); }
+    virtual void setData( const double data )
+    { b_impl->setData( data ); }
+        
+    virtual std::string objectType() const 
+    { return b_impl->objectType(); }
+    virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const 
+    { b_impl->serialize(buffer); }
+    virtual void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { b_impl->deserialize(buffer); }
+
+    bool isImplNonnull() const { return Teuchos::nonnull(b_impl); }
+
+  protected:
+
+    Teuchos::RCP<BaseClassImpl> b_impl;
+};
+
+//---------------------------------------------------------------------------//
+namespace Bricks
+{
+// AbstractBuildableObjectPolicy implementation for the base class.
+template<>
+class AbstractBuildableObjectPolicy<BaseClass>
+{
+  public:
+
+    typedef BaseClass object_type;
+
+    static std::string objectType( const BaseClass& object )
+    {
+	return object.objectType();
+    }
+
+    static Teuchos::RCP<Bricks::AbstractBuilder<BaseClass> > getBuilder()
+    {
+	return BaseClass::getBuilder();
+    }
+};
+
+// AbstractSerializableObjectPolicy implementation for the base class.
+template<>
+class AbstractSerializableObjectPolicy<BaseClass>
+{
+  public:
+
+    typedef BaseClass object_type;
+
+    static bool objectHasImplementation( const BaseClass& object )
+    {
+	return object.isImplNonnull();
+    }
+
+    static std::size_t maxByteSize()
+    {
+	return BaseClass::maxByteSize();
+    }
+
+    static std::size_t derivedClassByteSize( const int integral_key )
+    {
+	return BaseClass::derivedClassByteSize( integral_key );
+    }
+
+    static void serialize( const BaseClass& object,
+			   const Teuchos::ArrayView<char>& buffer )
+    {
+	object.serialize( buffer );
+    }
+
+    static void deserialize( BaseClass& object,
+			     const Teuchos::ArrayView<const char>& buffer )
+    {
+	object.deserialize( buffer );
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Derived class 1 implementation
+class MyNumberIsOneImpl : public BaseClassImpl
+{
+  public:
+
+    MyNumberIsOneImpl() : d_data( 1, 1.0 ) { /* ... */ }
+    ~MyNumberIsOneImpl() { /* ... */ }
+
+    int myNumber() { return 1; }
+    Teuchos::Array<double> myData() { return d_data; }
+    void setData( const double data )
+    { d_data.assign( d_data.size(), data ); }
+
+    std::string objectType() const { return std::string("one"); }
+    void serialize( const Teuchos::ArrayView<char>& buffer ) const
+    { std::memcpy( buffer.getRawPtr(), d_data.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
+    void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { std::memcpy( d_data.getRawPtr(), buffer.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
+
+    static std::size_t byteSize();
+
+  private: 
+    
+    Teuchos::Array<double> d_data;
+};
+
+std::size_t MyNumberIsOneImpl::byteSize()
+{ return sizeof(double); }
+
+// Derived class 1 interface
+class MyNumberIsOne : public BaseClass
+{
+  public:
+
+    MyNumberIsOne()
+    {
+	this->b_impl = Teuchos::rcp( new MyNumberIsOneImpl() );
+    }
+    ~MyNumberIsOne() { /* ... */ }
+
+    static std::size_t byteSize();
+};
+
+std::size_t MyNumberIsOne::byteSize()
+{ return MyNumberIsOneImpl::byteSize(); }
+
+// DerivedSerializableObjectPolicy
+namespace Bricks
+{
+template<>
+class DerivedSerializableObjectPolicy<MyNumberIsOne>
+{
+  public:
+    typedef MyNumberIsOne object_type;
+    static std::size_t byteSize()
+    {
+	return MyNumberIsOne::byteSize();
+    }
+};
+
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsOne>
+{
+  public:
+    typedef MyNumberIsOne object_type;
+    static std::string objectType()
+    {
+	return std::string("one");
+    }
+};
+
+// AbstractObjectRegistrationPolicy
+template<>
+class AbstractObjectRegistrationPolicy<MyNumberIsOne>
+{
+  public:
+
+    //! Base class type.
+    typedef MyNumberIsOne object_type;
+
+    /*!
+     * \brief Register a derived class with a base class.
+     */
+    static void registerDerivedClassWithBaseClass()
+    {
+	BaseClass::setDerivedClassFactory<MyNumberIsOne>();
+	BaseClass::setDerivedClassByteSize<MyNumberIsOne>();
+    }
+};
+
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Derived class 2 implementation.
+class MyNumberIsTwoImpl : public BaseClassImpl
+{
+  public:
+
+    MyNumberIsTwoImpl() : d_data( 2, 2.0 ) { /* ... */ }
+    ~MyNumberIsTwoImpl() { /* ... */ }
+
+    int myNumber() { return 2; }
+    Teuchos::Array<double> myData() { return d_data; }
+    void setData( const double data )
+    { d_data.assign( d_data.size(), data ); }
+
+    std::string objectType() const { return std::string("two"); }
+    void serialize( const Teuchos::ArrayView<char>& buffer ) const
+    { std::memcpy( buffer.getRawPtr(), d_data.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
+    void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { std::memcpy( d_data.getRawPtr(), buffer.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
+
+    static std::size_t byteSize();
+
+  private: 
+    
+    Teuchos::Array<double> d_data;
+};
+
+std::size_t MyNumberIsTwoImpl::byteSize()
+{ return 2*sizeof(double); }
+
+// Derived class 2 interface
+class MyNumberIsTwo : public BaseClass
+{
+  public:
+
+    MyNumberIsTwo()
+    {
+	this->b_impl = Teuchos::rcp( new MyNumberIsTwoImpl() );
+    }
+    ~MyNumberIsTwo() { /* ... */ }
+
+    static std::size_t byteSize();
+};
+
+std::size_t MyNumberIsTwo::byteSize()
+{ return MyNumberIsTwoImpl::byteSize(); }
+
+// DerivedSerializableObjectPolicy
+namespace Bricks
+{
+template<>
+class DerivedSerializableObjectPolicy<MyNumberIsTwo>
+{
+  public:
+    typedef MyNumberIsTwo object_type;
+    static std::size_t byteSize()
+    {
+	return MyNumberIsTwo::byteSize();
+    }
+};
+
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsTwo>
+{
+  public:
+    typedef MyNumberIsTwo object_type;
+    static std::string objectType()
+    {
+	return std::string("two");
+    }
+};
+
+// AbstractObjectRegistrationPolicy
+template<>
+class AbstractObjectRegistrationPolicy<MyNumberIsTwo>
+{
+  public:
+
+    //! Base class type.
+    typedef MyNumberIsTwo object_type;
+
+    /*!
+     * \brief Register a derived class with a base class.
+     */
+    static void registerDerivedClassWithBaseClass()
+    {
+	BaseClass::setDerivedClassFactory<MyNumberIsTwo>();
+	BaseClass::setDerivedClassByteSize<MyNumberIsTwo>();
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// HELPER FUNCTIONS
+//---------------------------------------------------------------------------//
+// Register the derived classes once for all tests.
+inline void registerDerivedClasses()
+{
+    static bool registered = false;
+    if ( !registered )
+    {
+	Bricks::AbstractObjectRegistry<
+	    BaseClass,MyNumberIsOne,MyNumberIsTwo>::registerDerivedClasses();
+	registered = true;
+    }
+}
+
+#endif // end Bricks_TSTABSTRACTOBJECTFIXTURE_HPP
+
+//---------------------------------------------------------------------------//
+// end of tstAbstractObjectFixture.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,301 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstAbstractObjectVariant.cpp
+ * \author Stuart Slattery
+ * \brief  Abstract object variant class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <Bricks_AbstractObjectVariant.hpp>
+#include <Bricks_AbstractVariantSerializer.hpp>
+#include <Bricks_AbstractSerializableObject.hpp>
+#include <Bricks_AbstractBuildableObject.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayView.hpp"
+
+//---------------------------------------------------------------------------//
+// HELPER CLASSES
+//---------------------------------------------------------------------------//
+// Base class interface. Derived classes hold their data inline.
+class BaseClass
+{
+  public:
+
+    BaseClass() { ++b_num_live; }
+    BaseClass( const BaseClass& ) { ++b_num_live; }
+    virtual ~BaseClass() { --b_num_live; }
+
+    virtual int myNumber() const = 0;
+    virtual double myData() const = 0;
+    virtual void setData( const double data ) = 0;
+    virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const = 0;
+    virtual void deserialize( const Teuchos::ArrayView<const char>& buffer ) = 0;
+
+    static int b_num_live;
+};
+
+int BaseClass::b_num_live = 0;
+
+//---------------------------------------------------------------------------//
+namespace Bricks
+{
+// AbstractSerializableObjectPolicy implementation for the base class.
+template<>
+class AbstractSerializableObjectPolicy<BaseClass>
+{
+  public:
+
+    typedef BaseClass object_type;
+
+    static void serialize( const BaseClass& object,
+			   const Teuchos::ArrayView<char>& buffer )
+    {
+	object.serialize( buffer );
+    }
+
+    static void deserialize( BaseClass& object,
+			     const Teuchos::ArrayView<const char>& buffer )
+    {
+	object.deserialize( buffer );
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Derived class 1.
+class MyNumberIsOne : public BaseClass
+{
+  public:
+
+    MyNumberIsOne() { d_data[0] = 1.0; }
+    int myNumber() const { return 1; }
+    double myData() const { return d_data[0]; }
+    void setData( const double data ) { d_data[0] = data; }
+    void serialize( const Teuchos::ArrayView<char>& buffer ) const
+    { std::memcpy( buffer.getRawPtr(), d_data, sizeof(d_data) ); }
+    void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { std::memcpy( d_data, buffer.getRawPtr(), sizeof(d_data) ); }
+
+  private:
+
+    double d_data[1];
+};
+
+//---------------------------------------------------------------------------//
+// Derived class 2.
+class MyNumberIsTwo : public BaseClass
+{
+  public:
+
+    MyNumberIsTwo() { d_data[0] = 2.0; d_data[1] = 2.0; }
+    int myNumber() const { return 2; }
+    double myData() const { return d_data[1]; }
+    void setData( const double data ) { d_data[0] = data; d_data[1] = data; }
+    void serialize( const Teuchos::ArrayView<char>& buffer ) const
+    { std::memcpy( buffer.getRawPtr(), d_data, sizeof(d_data) ); }
+    void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { std::memcpy( d_data, buffer.getRawPtr(), sizeof(d_data) ); }
+
+  private:
+
+    double d_data[2];
+};
+
+//---------------------------------------------------------------------------//
+namespace Bricks
+{
+// DerivedSerializableObjectPolicy implementations.
+template<>
+class DerivedSerializableObjectPolicy<MyNumberIsOne>
+{
+  public:
+    typedef MyNumberIsOne object_type;
+    static constexpr std::size_t byteSize()
+    { return sizeof(double); }
+};
+
+template<>
+class DerivedSerializableObjectPolicy<MyNumberIsTwo>
+{
+  public:
+    typedef MyNumberIsTwo object_type;
+    static constexpr std::size_t byteSize()
+    { return 2*sizeof(double); }
+};
+
+// DerivedBuildableObjectPolicy implementations.
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsOne>
+{
+  public:
+    typedef MyNumberIsOne object_type;
+    static std::string objectType()
+    { return std::string("one"); }
+};
+
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsTwo>
+{
+  public:
+    typedef MyNumberIsTwo object_type;
+    static std::string objectType()
+    { return std::string("two"); }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Variant type.
+typedef Bricks::AbstractObjectVariant<BaseClass,MyNumberIsOne,MyNumberIsTwo>
+Variant;
+
+//---------------------------------------------------------------------------//
+// Visitor that records the derived class of an object.
+struct NumberVisitor
+{
+    int d_number;
+    void operator()( MyNumberIsOne& ) { d_number = 1; }
+    void operator()( MyNumberIsTwo& ) { d_number = 2; }
+};
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractObjectVariant, storage )
+{
+    // The objects are held inline.
+    TEST_ASSERT( sizeof(Variant) >= sizeof(MyNumberIsTwo) );
+    TEST_ASSERT( sizeof(Variant) <= sizeof(MyNumberIsTwo) + sizeof(double) );
+    TEST_EQUALITY( 2, Variant::num_derived_types );
+
+    Variant variant;
+    TEST_ASSERT( variant.empty() );
+    TEST_EQUALITY( -1, variant.index() );
+    TEST_EQUALITY( 0, BaseClass::b_num_live );
+
+    // Build by registry position.
+    variant.emplace( 1 );
+    TEST_ASSERT( variant.holds<MyNumberIsTwo>() );
+    TEST_EQUALITY( 2, variant->myNumber() );
+    TEST_EQUALITY( "two", variant.objectType() );
+    TEST_EQUALITY( static_cast<const void*>(&variant.get()),
+		   static_cast<const void*>(&variant) );
+    TEST_EQUALITY( 1, BaseClass::b_num_live );
+
+    // Replacing the object destroys the old one.
+    MyNumberIsOne& one = variant.emplace<MyNumberIsOne>();
+    one.setData( 3.0 );
+    TEST_EQUALITY( 0, variant.index() );
+    TEST_EQUALITY( 1, (*variant).myNumber() );
+    TEST_EQUALITY( 3.0, variant.get<MyNumberIsOne>().myData() );
+    TEST_EQUALITY( 1, BaseClass::b_num_live );
+
+    variant.clear();
+    TEST_ASSERT( variant.empty() );
+    TEST_EQUALITY( 0, BaseClass::b_num_live );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractObjectVariant, value_semantics )
+{
+    {
+	Variant variant = Variant::create( 0 );
+	variant->setData( 4.0 );
+
+	// Copies do not share data.
+	Variant copy( variant );
+	copy->setData( 5.0 );
+	TEST_EQUALITY( 4.0, variant->myData() );
+	TEST_EQUALITY( 5.0, copy->myData() );
+	TEST_EQUALITY( 2, BaseClass::b_num_live );
+
+	// Assignment replaces the derived class.
+	MyNumberIsTwo two;
+	two.setData( 6.0 );
+	copy.assign( two );
+	TEST_EQUALITY( 2, copy->myNumber() );
+	variant = copy;
+	TEST_EQUALITY( 2, variant->myNumber() );
+	TEST_EQUALITY( 6.0, variant->myData() );
+	TEST_EQUALITY( 3, BaseClass::b_num_live );
+
+	// Arrays of variants are contiguous.
+	Teuchos::Array<Variant> variants( 4, variant );
+	variants[1].emplace( 0 );
+	TEST_EQUALITY( &variants[0] + 1, &variants[1] );
+	TEST_EQUALITY( 1, variants[1]->myNumber() );
+	TEST_EQUALITY( 2, variants[3]->myNumber() );
+	TEST_EQUALITY( 7, BaseClass::b_num_live );
+
+	// Visitors see the derived class.
+	NumberVisitor visitor;
+	for ( int i = 0; i < 4; ++i )
+	{
+	    variants[i].apply( visitor );
+	    TEST_EQUALITY( variants[i]->myNumber(), visitor.d_number );
+	}
+    }
+    TEST_EQUALITY( 0, BaseClass::b_num_live );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractObjectVariant, serializer )
+{
+    typedef Bricks::AbstractVariantSerializer<int,Variant> Serializer;
+    TEST_EQUALITY( sizeof(int) + 2*sizeof(double), 
+		   Serializer::recordByteSize() );
+
+    // The sizes are compile time constants.
+    static_assert( 2*sizeof(double) == Variant::Registry::maxByteSize(),
+		   "registry maximum byte size" );
+    static_assert( sizeof(double) == 
+		   Variant::Registry::byteSize<MyNumberIsOne>(),
+		   "registry derived class byte size" );
+    char record[ Serializer::recordByteSize() ];
+    TEST_EQUALITY( sizeof(record), Serializer::recordByteSize() );
+
+    // Build a batch with an empty variant.
+    int num_obj = 5;
+    Teuchos::Array<Variant> objects( num_obj );
+    for ( int i = 0; i < num_obj - 1; ++i )
+    {
+	objects[i].emplace( i % 2 );
+	objects[i]->setData( i );
+    }
+
+    // Serialize.
+    int bytes = Serializer::fromCountToIndirectBytes( num_obj, 
+						      objects.getRawPtr() );
+    TEST_EQUALITY( bytes, int(num_obj*Serializer::recordByteSize()) );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serialize( num_obj, objects.getRawPtr(), 
+			   bytes, buffer.getRawPtr() );
+
+    // Deserialize into a mix of empty, matching and mismatched variants.
+    TEST_EQUALITY( num_obj, 
+		   Serializer::fromIndirectBytesToCount(bytes,buffer.getRawPtr()) );
+    Teuchos::Array<Variant> targets( num_obj );
+    targets[1].emplace( 1 );
+    targets[2].emplace( 1 );
+    targets[4].emplace( 0 );
+    Serializer::deserialize( bytes, buffer.getRawPtr(), 
+			     num_obj, targets.getRawPtr() );
+    for ( int i = 0; i < num_obj - 1; ++i )
+    {
+	TEST_EQUALITY( i % 2, targets[i].index() );
+	TEST_EQUALITY( i % 2 + 1, targets[i]->myNumber() );
+	TEST_EQUALITY( double(i), targets[i]->myData() );
+    }
+    TEST_ASSERT( targets[num_obj-1].empty() );
+}
+
+//---------------------------------------------------------------------------//
+// end of tstAbstractObjectVariant.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,139 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstAbstractSerializedIterator.cpp
+ * \author Stuart Slattery
+ * \brief  Abstract serialized iterator class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <functional>
+
+#include <Bricks_AbstractSerializedIterator.hpp>
+#include <Bricks_AbstractIterator.hpp>
+#include <Bricks_AbstractSerializer.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_SerializationTraits.hpp"
+#include "Teuchos_as.hpp"
+
+#include "tstAbstractObjectFixture.hpp"
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializedIterator, serialized_iterator )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Construct an array of base class objects. Leave some without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 9;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	if ( i % 3 != 2 )
+	{
+	    objects[i] = *( builder->create( (i%3) ? "two" : "one" ) );
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // Check both formats.
+    Teuchos::Array<Serializer::Format> formats( 2 );
+    formats[0] = Serializer::FIXED_STRIDE;
+    formats[1] = Serializer::COMPACT;
+    for ( int f = 0; f < formats.size(); ++f )
+    {
+	Serializer::setFormat( formats[f] );
+
+	// Serialize the objects.
+	int bytes = Serializer::fromCountToPackedBytes( 
+	    objects.size(), objects.getRawPtr() );
+	Teuchos::ArrayRCP<char> buffer = Teuchos::arcp<char>( bytes );
+	Serializer::serializePacked( 
+	    objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+	// Iterate over all of the records.
+	AbstractIterator<BaseClass> all_it = 
+	    AbstractSerializedIterator<BaseClass>( buffer );
+	TEST_EQUALITY( all_it.size(), Teuchos::as<std::size_t>(num_objects) );
+	int i = 0;
+	for ( all_it = all_it.begin(); all_it != all_it.end(); ++all_it, ++i )
+	{
+	    if ( i % 3 == 2 )
+	    {
+		TEST_ASSERT( !all_it->isImplNonnull() );
+	    }
+	    else
+	    {
+		int number = (i%3) ? 2 : 1;
+		TEST_EQUALITY( number, all_it->myNumber() );
+		TEST_EQUALITY( 1.0*i, (*all_it).myData()[number-1] );
+	    }
+	}
+	TEST_EQUALITY( i, num_objects );
+
+	// Iterate over the records of the second derived class.
+	std::function<bool(BaseClass&)> two_func = 
+	    [](BaseClass& b){ return b.isImplNonnull() && 2 == b.myNumber(); };
+	AbstractIterator<BaseClass> two_it = 
+	    AbstractSerializedIterator<BaseClass>( buffer, two_func );
+	TEST_EQUALITY( two_it.size(), 3u );
+	i = 1;
+	for ( two_it = two_it.begin(); two_it != two_it.end(); ++two_it )
+	{
+	    TEST_EQUALITY( 2, two_it->myNumber() );
+	    TEST_EQUALITY( 1.0*i, two_it->myData()[0] );
+	    i += 3;
+	}
+	TEST_EQUALITY( i, num_objects + 1 );
+
+	// Records are read with the layout and key size of the buffer even if
+	// the settings change after it is written.
+	Serializer::setNarrowKeys( true );
+	bytes = Serializer::fromCountToPackedBytes( 
+	    objects.size(), objects.getRawPtr() );
+	Teuchos::ArrayRCP<char> narrow_buffer = Teuchos::arcp<char>( bytes );
+	Serializer::serializePacked( objects.size(), objects.getRawPtr(), 
+				     bytes, narrow_buffer.getRawPtr() );
+	AbstractIterator<BaseClass> narrow_it = 
+	    AbstractSerializedIterator<BaseClass>( narrow_buffer );
+	Serializer::setNarrowKeys( false );
+	Serializer::setFormat( formats[(f+1) % formats.size()] );
+	i = 0;
+	for ( narrow_it = narrow_it.begin(); 
+	      narrow_it != narrow_it.end(); 
+	      ++narrow_it, ++i )
+	{
+	    TEST_EQUALITY( i % 3 != 2, narrow_it->isImplNonnull() );
+	    if ( i % 3 != 2 )
+	    {
+		int number = (i%3) ? 2 : 1;
+		TEST_EQUALITY( number, narrow_it->myNumber() );
+		TEST_EQUALITY( 1.0*i, narrow_it->myData()[number-1] );
+	    }
+	}
+	TEST_EQUALITY( i, num_objects );
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+// end of tstAbstractSerializedIterator.cpp
+//---------------------------------------------------------------------------//
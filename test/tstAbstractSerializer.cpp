@@ -25,6 +25,7 @@
 #include "Teuchos_DefaultComm.hpp"
 #include "Teuchos_CommHelpers.hpp"
 #include "Teuchos_SerializationTraits.hpp"
+#include "Teuchos_as.hpp"
 
 //---------------------------------------------------------------------------//
 // HELPER CLASSES
@@ -35,15 +36,25 @@ class BaseClassImpl
 {
   public:
 
-    BaseClassImpl() { /* ... */ }
+    BaseClassImpl() : d_version( nextVersion() ) { /* ... */ }
     virtual ~BaseClassImpl() { /* ... */ }
 
+    std::size_t version() const { return d_version; }
+    static std::size_t nextVersion()
+    { static std::size_t counter = 0; return counter++; }
+
     virtual int myNumber() = 0;
     virtual Teuchos::Array<double> myData() = 0;
+    virtual void setData( const double data ) = 0;
         
     virtual std::string objectType() const = 0;
+    virtual int objectIntegralKey() const = 0;
     virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const = 0;
     virtual void deserialize( const Teuchos::ArrayView<const char>& buffer ) = 0;
+
+  protected:
+
+    std::size_t d_version;
 };
 
 // Base class interface.
@@ -58,9 +69,13 @@ class BaseClass : public Bricks::AbstractBuildableObject<BaseClass>
     virtual int myNumber() { return b_impl->myNumber(); }
     virtual Teuchos::Array<double> myData() 
     { return b_impl->myData(); }
+    virtual void setData( const double data )
+    { b_impl->setData( data ); }
         
     virtual std::string objectType() const 
     { return b_impl->objectType(); }
+    virtual int objectIntegralKey() const
+    { return b_impl->objectIntegralKey(); }
     virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const 
     { b_impl->serialize(buffer); }
     virtual void deserialize( const Teuchos::ArrayView<const char>& buffer )
@@ -68,11 +83,19 @@ class BaseClass : public Bricks::AbstractBuildableObject<BaseClass>
 
     bool isImplNonnull() const { return Teuchos::nonnull(b_impl); }
 
+    bool isImplShared() const { return b_impl.strong_count() > 1; }
+
+    std::size_t version() const { return b_impl->version(); }
+
   protected:
 
     Teuchos::RCP<BaseClassImpl> b_impl;
 };
 
+// Derived classes.
+class MyNumberIsOne;
+class MyNumberIsTwo;
+
 //---------------------------------------------------------------------------//
 namespace Bricks
 {
@@ -89,6 +112,16 @@ class AbstractBuildableObjectPolicy<BaseClass>
 	return object.objectType();
     }
 
+    static int objectIntegralKey( const BaseClass& object )
+    {
+	return object.objectIntegralKey();
+    }
+
+    static bool objectIsShared( const BaseClass& object )
+    {
+	return object.isImplShared();
+    }
+
     static Teuchos::RCP<Bricks::AbstractBuilder<BaseClass> > getBuilder()
     {
 	return BaseClass::getBuilder();
@@ -103,6 +136,9 @@ class AbstractSerializableObjectPolicy<BaseClass>
 
     typedef BaseClass object_type;
 
+    typedef AbstractObjectRegistry<BaseClass,MyNumberIsOne,MyNumberIsTwo>
+    registry_type;
+
     static bool objectHasImplementation( const BaseClass& object )
     {
 	return object.isImplNonnull();
@@ -113,6 +149,16 @@ class AbstractSerializableObjectPolicy<BaseClass>
 	return BaseClass::maxByteSize();
     }
 
+    static std::size_t derivedClassByteSize( const int integral_key )
+    {
+	return BaseClass::derivedClassByteSize( integral_key );
+    }
+
+    static std::size_t objectVersion( const BaseClass& object )
+    {
+	return object.version();
+    }
+
     static void serialize( const BaseClass& object,
 			   const Teuchos::ArrayView<char>& buffer )
     {
@@ -183,25 +229,25 @@ class MyNumberIsOneImpl : public BaseClassImpl
 
     int myNumber() { return 1; }
     Teuchos::Array<double> myData() { return d_data; }
+    void setData( const double data )
+    { d_data.assign( d_data.size(), data ); d_version = nextVersion(); }
 
     std::string objectType() const { return std::string("one"); }
+    int objectIntegralKey() const;
     void serialize( const Teuchos::ArrayView<char>& buffer ) const
-    { std::memcpy( const_cast<double*>(d_data.getRawPtr()), 
-		   buffer.getRawPtr(), sizeof(double) ); }
+    { std::memcpy( buffer.getRawPtr(), d_data.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
     void deserialize( const Teuchos::ArrayView<const char>& buffer )
-    { std::memcpy( const_cast<char*>(buffer.getRawPtr()), 
-		   d_data.getRawPtr(), sizeof(double) ); }
+    { std::memcpy( d_data.getRawPtr(), buffer.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
 
-    static std::size_t byteSize();
+    static constexpr std::size_t byteSize() { return sizeof(double); }
 
   private: 
     
     Teuchos::Array<double> d_data;
 };
 
-std::size_t MyNumberIsOneImpl::byteSize()
-{ return sizeof(double); }
-
 // Derived class 1 interface
 class MyNumberIsOne : public BaseClass
 {
@@ -213,11 +259,12 @@ class MyNumberIsOne : public BaseClass
     }
     ~MyNumberIsOne() { /* ... */ }
 
-    static std::size_t byteSize();
+    static constexpr std::size_t byteSize()
+    { return MyNumberIsOneImpl::byteSize(); }
 };
 
-std::size_t MyNumberIsOne::byteSize()
-{ return MyNumberIsOneImpl::byteSize(); }
+int MyNumberIsOneImpl::objectIntegralKey() const
+{ return BaseClass::integralKey<MyNumberIsOne>(); }
 
 // DerivedSerializableObjectPolicy
 namespace Bricks
@@ -227,12 +274,24 @@ class DerivedSerializableObjectPolicy<MyNumberIsOne>
 {
   public:
     typedef MyNumberIsOne object_type;
-    static std::size_t byteSize()
+    static constexpr std::size_t byteSize()
     {
 	return MyNumberIsOne::byteSize();
     }
 };
 
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsOne>
+{
+  public:
+    typedef MyNumberIsOne object_type;
+    static std::string objectType()
+    {
+	return std::string("one");
+    }
+};
+
 // AbstractObjectRegistrationPolicy
 template<>
 class AbstractObjectRegistrationPolicy<MyNumberIsOne>
@@ -247,8 +306,9 @@ class AbstractObjectRegistrationPolicy<MyNumberIsOne>
      */
     static void registerDerivedClassWithBaseClass()
     {
-	BaseClass::setDerivedClassFactory<MyNumberIsOne>();
+	// The byte size may be set before the factory.
 	BaseClass::setDerivedClassByteSize<MyNumberIsOne>();
+	BaseClass::setDerivedClassFactory<MyNumberIsOne>();
     }
 };
 
@@ -265,25 +325,25 @@ class MyNumberIsTwoImpl : public BaseClassImpl
 
     int myNumber() { return 2; }
     Teuchos::Array<double> myData() { return d_data; }
+    void setData( const double data )
+    { d_data.assign( d_data.size(), data ); d_version = nextVersion(); }
 
     std::string objectType() const { return std::string("two"); }
+    int objectIntegralKey() const;
     void serialize( const Teuchos::ArrayView<char>& buffer ) const
-    { std::memcpy( const_cast<double*>(d_data.getRawPtr()), 
-		   buffer.getRawPtr(), sizeof(double) ); }
+    { std::memcpy( buffer.getRawPtr(), d_data.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
     void deserialize( const Teuchos::ArrayView<const char>& buffer )
-    { std::memcpy( const_cast<char*>(buffer.getRawPtr()), 
-		   d_data.getRawPtr(), sizeof(double) ); }
+    { std::memcpy( d_data.getRawPtr(), buffer.getRawPtr(), 
+		   d_data.size()*sizeof(double) ); }
 
-    static std::size_t byteSize();
+    static constexpr std::size_t byteSize() { return 2*sizeof(double); }
 
   private: 
     
     Teuchos::Array<double> d_data;
 };
 
-std::size_t MyNumberIsTwoImpl::byteSize()
-{ return 2*sizeof(double); }
-
 // Derived class 2 interface
 class MyNumberIsTwo : public BaseClass
 {
@@ -295,11 +355,12 @@ class MyNumberIsTwo : public BaseClass
     }
     ~MyNumberIsTwo() { /* ... */ }
 
-    static std::size_t byteSize();
+    static constexpr std::size_t byteSize()
+    { return MyNumberIsTwoImpl::byteSize(); }
 };
 
-std::size_t MyNumberIsTwo::byteSize()
-{ return MyNumberIsTwoImpl::byteSize(); }
+int MyNumberIsTwoImpl::objectIntegralKey() const
+{ return BaseClass::integralKey<MyNumberIsTwo>(); }
 
 // DerivedSerializableObjectPolicy
 namespace Bricks
@@ -309,12 +370,24 @@ class DerivedSerializableObjectPolicy<MyNumberIsTwo>
 {
   public:
     typedef MyNumberIsTwo object_type;
-    static std::size_t byteSize()
+    static constexpr std::size_t byteSize()
     {
 	return MyNumberIsTwo::byteSize();
     }
 };
 
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsTwo>
+{
+  public:
+    typedef MyNumberIsTwo object_type;
+    static std::string objectType()
+    {
+	return std::string("two");
+    }
+};
+
 // AbstractObjectRegistrationPolicy
 template<>
 class AbstractObjectRegistrationPolicy<MyNumberIsTwo>
@@ -336,42 +409,1737 @@ class AbstractObjectRegistrationPolicy<MyNumberIsTwo>
 } // end namespace Bricks
 
 //---------------------------------------------------------------------------//
-// TESTS
+// Base class interface with a single derived class.
+class SingleBaseClass : public Bricks::AbstractBuildableObject<SingleBaseClass>
+		      , public Bricks::AbstractSerializableObject<SingleBaseClass>
+{
+  public:
+
+    SingleBaseClass() { /* ... */ }
+    virtual ~SingleBaseClass() { /* ... */ }
+
+    virtual int myNumber() { return b_impl->myNumber(); }
+    virtual Teuchos::Array<double> myData() 
+    { return b_impl->myData(); }
+    virtual void setData( const double data )
+    { b_impl->setData( data ); }
+        
+    virtual std::string objectType() const 
+    { return b_impl->objectType(); }
+    virtual void serialize( const Teuchos::ArrayView<char>& buffer ) const 
+    { b_impl->serialize(buffer); }
+    virtual void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { b_impl->deserialize(buffer); }
+
+    bool isImplNonnull() const { return Teuchos::nonnull(b_impl); }
+
+  protected:
+
+    Teuchos::RCP<BaseClassImpl> b_impl;
+};
+
+// The only derived class.
+class SingleMyNumberIsTwo : public SingleBaseClass
+{
+  public:
+
+    SingleMyNumberIsTwo()
+    {
+	this->b_impl = Teuchos::rcp( new MyNumberIsTwoImpl() );
+    }
+    ~SingleMyNumberIsTwo() { /* ... */ }
+
+    static std::size_t byteSize()
+    { return MyNumberIsTwoImpl::byteSize(); }
+};
+
+namespace Bricks
+{
+// AbstractBuildableObjectPolicy implementation for the single base class.
+template<>
+class AbstractBuildableObjectPolicy<SingleBaseClass>
+{
+  public:
+
+    typedef SingleBaseClass object_type;
+
+    static std::string objectType( const SingleBaseClass& object )
+    {
+	return object.objectType();
+    }
+
+    static Teuchos::RCP<Bricks::AbstractBuilder<SingleBaseClass> > getBuilder()
+    {
+	return SingleBaseClass::getBuilder();
+    }
+};
+
+// AbstractSerializableObjectPolicy implementation for the single base class.
+template<>
+class AbstractSerializableObjectPolicy<SingleBaseClass>
+{
+  public:
+
+    typedef SingleBaseClass object_type;
+
+    static bool objectHasImplementation( const SingleBaseClass& object )
+    {
+	return object.isImplNonnull();
+    }
+
+    static std::size_t maxByteSize()
+    {
+	return SingleBaseClass::maxByteSize();
+    }
+
+    static void serialize( const SingleBaseClass& object,
+			   const Teuchos::ArrayView<char>& buffer )
+    {
+	object.serialize( buffer );
+    }
+
+    static void deserialize( SingleBaseClass& object,
+			     const Teuchos::ArrayView<const char>& buffer )
+    {
+	object.deserialize( buffer );
+    }
+};
+
+// DerivedSerializableObjectPolicy
+template<>
+class DerivedSerializableObjectPolicy<SingleMyNumberIsTwo>
+{
+  public:
+    typedef SingleMyNumberIsTwo object_type;
+    static std::size_t byteSize()
+    {
+	return SingleMyNumberIsTwo::byteSize();
+    }
+};
+
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<SingleMyNumberIsTwo>
+{
+  public:
+    typedef SingleMyNumberIsTwo object_type;
+    static std::string objectType()
+    {
+	return std::string("two");
+    }
+};
+
+// AbstractObjectRegistrationPolicy
+template<>
+class AbstractObjectRegistrationPolicy<SingleMyNumberIsTwo>
+{
+  public:
+
+    //! Base class type.
+    typedef SingleMyNumberIsTwo object_type;
+
+    /*!
+     * \brief Register a derived class with a base class.
+     */
+    static void registerDerivedClassWithBaseClass()
+    {
+	SingleBaseClass::setDerivedClassFactory<SingleMyNumberIsTwo>();
+	SingleBaseClass::setDerivedClassByteSize<SingleMyNumberIsTwo>();
+    }
+};
+} // end namespace Bricks
+
 //---------------------------------------------------------------------------//
-TEUCHOS_UNIT_TEST( AbstractSerializer, abstract_serializer )
+// Base class interface for objects with run time sized data.
+class TallyBaseClass : public Bricks::AbstractBuildableObject<TallyBaseClass>
 {
-    using namespace Bricks;
+  public:
 
-    // Register derived classes.
-    AbstractObjectRegistry<BaseClass,
-			   MyNumberIsOne,MyNumberIsTwo>::registerDerivedClasses();
+    TallyBaseClass() { /* ... */ }
+    virtual ~TallyBaseClass() { /* ... */ }
 
-    // Get the communicator.
-    Teuchos::RCP<const Teuchos::Comm<int> > comm_default = 
-	Teuchos::DefaultComm<int>::getComm();
-    int comm_rank = comm_default->getRank();
+    Teuchos::Array<double> myData() const { return *b_data; }
+    void setData( const int size, const double data )
+    { b_data->assign( size, data ); }
 
-    // Construct an array of base class objects
-    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
-    Teuchos::Array<BaseClass> objects( 2 );
-    if ( comm_rank == 0 )
+    std::string objectType() const { return std::string("tally"); }
+    std::size_t byteSize() const { return b_data->size()*sizeof(double); }
+    void serialize( const Teuchos::ArrayView<char>& buffer ) const
+    { std::memcpy( buffer.getRawPtr(), b_data->getRawPtr(), byteSize() ); }
+    void deserialize( const Teuchos::ArrayView<const char>& buffer )
+    { b_data->resize( buffer.size() / sizeof(double) );
+      std::memcpy( b_data->getRawPtr(), buffer.getRawPtr(), byteSize() ); }
+
+    bool isImplNonnull() const { return Teuchos::nonnull(b_data); }
+
+  protected:
+
+    Teuchos::RCP<Teuchos::Array<double> > b_data;
+};
+
+// The only derived class.
+class Tally : public TallyBaseClass
+{
+  public:
+
+    Tally()
     {
-	objects[0] = *( builder->create("one") );
-	objects[1] = *( builder->create("two") );
+	this->b_data = Teuchos::rcp( new Teuchos::Array<double>(1, 0.0) );
     }
+    ~Tally() { /* ... */ }
+};
 
-    // Broadcast the objects.
-    Teuchos::broadcast( *comm_default, 0, objects() );
+namespace Bricks
+{
+// AbstractBuildableObjectPolicy implementation for the tally base class.
+template<>
+class AbstractBuildableObjectPolicy<TallyBaseClass>
+{
+  public:
 
-    // Check the objects.
-    TEST_EQUALITY( 1, objects[0].myNumber() );
-    TEST_EQUALITY( 1, objects[0].myData().size() );
-    TEST_EQUALITY( 1.0, objects[0].myData()[0] );
+    typedef TallyBaseClass object_type;
 
-    TEST_EQUALITY( 2, objects[1].myNumber() );
-    TEST_EQUALITY( 2, objects[1].myData().size() );
-    TEST_EQUALITY( 2.0, objects[1].myData()[0] );
-    TEST_EQUALITY( 2.0, objects[1].myData()[1] );
+    static std::string objectType( const TallyBaseClass& object )
+    {
+	return object.objectType();
+    }
+
+    static Teuchos::RCP<Bricks::AbstractBuilder<TallyBaseClass> > getBuilder()
+    {
+	return TallyBaseClass::getBuilder();
+    }
+};
+
+// AbstractSerializableObjectPolicy implementation for the tally base class.
+template<>
+class AbstractSerializableObjectPolicy<TallyBaseClass>
+{
+  public:
+
+    typedef TallyBaseClass object_type;
+
+    static bool objectHasImplementation( const TallyBaseClass& object )
+    {
+	return object.isImplNonnull();
+    }
+
+    static std::size_t maxByteSize()
+    {
+	return 16*sizeof(double);
+    }
+
+    static std::size_t objectByteSize( const TallyBaseClass& object )
+    {
+	return object.byteSize();
+    }
+
+    static void serialize( const TallyBaseClass& object,
+			   const Teuchos::ArrayView<char>& buffer )
+    {
+	object.serialize( buffer );
+    }
+
+    static void deserialize( TallyBaseClass& object,
+			     const Teuchos::ArrayView<const char>& buffer )
+    {
+	object.deserialize( buffer );
+    }
+};
+
+// DerivedBuildableObjectPolicy
+template<>
+class DerivedBuildableObjectPolicy<Tally>
+{
+  public:
+    typedef Tally object_type;
+    static std::string objectType()
+    {
+	return std::string("tally");
+    }
+};
+
+// AbstractObjectRegistrationPolicy
+template<>
+class AbstractObjectRegistrationPolicy<Tally>
+{
+  public:
+
+    //! Base class type.
+    typedef Tally object_type;
+
+    /*!
+     * \brief Register a derived class with a base class.
+     */
+    static void registerDerivedClassWithBaseClass()
+    {
+	TallyBaseClass::setDerivedClassFactory<Tally>();
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// SerializationTraits implementation for the tally base class.
+namespace Teuchos
+{
+template<typename Ordinal>
+class SerializationTraits<Ordinal,TallyBaseClass> 
+{
+  public:
+
+    typedef Bricks::AbstractSerializer<Ordinal,TallyBaseClass>  
+    AbstractSerializer;
+
+    static const bool supportsDirectSerialization = 
+	AbstractSerializer::supportsDirectSerialization;
+
+    static Ordinal fromCountToIndirectBytes( const Ordinal count, 
+					     const TallyBaseClass buffer[] ) 
+    { 
+	return AbstractSerializer::fromCountToIndirectBytes( count, buffer );
+    }
+
+    static void serialize( const Ordinal count, 
+			   const TallyBaseClass buffer[], 
+			   const Ordinal bytes, 
+			   char charBuffer[] )
+    { 
+	AbstractSerializer::serialize( count, buffer, bytes, charBuffer );
+    }
+
+    static Ordinal fromIndirectBytesToCount( const Ordinal bytes, 
+					     const char charBuffer[] ) 
+    { 
+	return AbstractSerializer::fromIndirectBytesToCount( bytes, charBuffer );
+    }
+
+    static void deserialize( const Ordinal bytes, 
+			     const char charBuffer[], 
+			     const Ordinal count, 
+			     TallyBaseClass buffer[] )
+    { 
+	AbstractSerializer::deserialize( bytes, charBuffer, count, buffer );
+    }
+};
+} // end namespace Teuchos
+
+//---------------------------------------------------------------------------//
+// Trivially copyable objects serialized as their bytes.
+struct Point
+{
+    double x;
+    double y;
+};
+
+// Number of points serialized one at a time.
+int num_point_serializations = 0;
+
+namespace Bricks
+{
+// AbstractBuildableObjectPolicy implementation for points.
+template<>
+class AbstractBuildableObjectPolicy<Point>
+{
+  public:
+
+    typedef Point object_type;
+
+    static std::string objectType( const Point& )
+    {
+	return std::string("point");
+    }
+
+    static Teuchos::RCP<Bricks::AbstractBuilder<Point> > getBuilder()
+    {
+	static Teuchos::RCP<Bricks::AbstractBuilder<Point> > builder =
+	    Teuchos::rcp( new Bricks::AbstractBuilder<Point>() );
+	return builder;
+    }
+};
+
+// AbstractSerializableObjectPolicy implementation for points.
+template<>
+class AbstractSerializableObjectPolicy<Point>
+{
+  public:
+
+    typedef Point object_type;
+
+    static bool objectHasImplementation( const Point& )
+    {
+	return true;
+    }
+
+    static std::size_t maxByteSize()
+    {
+	return sizeof(Point);
+    }
+
+    static bool bitwiseSerializable()
+    {
+	return true;
+    }
+
+    static void serialize( const Point& object,
+			   const Teuchos::ArrayView<char>& buffer )
+    {
+	++num_point_serializations;
+	std::memcpy( buffer.getRawPtr(), &object, sizeof(Point) );
+    }
+
+    static void deserialize( Point& object,
+			     const Teuchos::ArrayView<const char>& buffer )
+    {
+	std::memcpy( &object, buffer.getRawPtr(), sizeof(Point) );
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// HELPER FUNCTIONS
+//---------------------------------------------------------------------------//
+// Register the derived classes once for all tests.
+void registerDerivedClasses()
+{
+    static bool registered = false;
+    if ( !registered )
+    {
+	Bricks::AbstractObjectRegistry<
+	    BaseClass,MyNumberIsOne,MyNumberIsTwo>::registerDerivedClasses();
+	Bricks::AbstractObjectRegistry<
+	    SingleBaseClass,SingleMyNumberIsTwo>::registerDerivedClasses();
+	Bricks::AbstractObjectRegistry<
+	    TallyBaseClass,Tally>::registerDerivedClasses();
+	BaseClass::getBuilder()->freeze();
+	SingleBaseClass::getBuilder()->freeze();
+	// Tallies are built in parallel with parallel packing.
+	TallyBaseClass::getBuilder()->freeze( true );
+	Bricks::AbstractBuildableObjectPolicy<Point>::getBuilder()
+	    ->setDerivedClassFactory<Point>( "point" );
+	registered = true;
+    }
+}
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, abstract_serializer )
+{
+    using namespace Bricks;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_default = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm_default->getRank();
+
+    // Construct an array of base class objects
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> objects( 2 );
+    if ( comm_rank == 0 )
+    {
+	objects[0] = *( builder->create("one") );
+	objects[1] = *( builder->create("two") );
+    }
+
+    // Broadcast the objects.
+    Teuchos::broadcast( *comm_default, 0, objects() );
+
+    // Check the objects.
+    TEST_EQUALITY( 1, objects[0].myNumber() );
+    TEST_EQUALITY( 1, objects[0].myData().size() );
+    TEST_EQUALITY( 1.0, objects[0].myData()[0] );
+
+    TEST_EQUALITY( 2, objects[1].myNumber() );
+    TEST_EQUALITY( 2, objects[1].myData().size() );
+    TEST_EQUALITY( 2.0, objects[1].myData()[0] );
+    TEST_EQUALITY( 2.0, objects[1].myData()[1] );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, compact_serializer )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::COMPACT );
+    TEST_EQUALITY( Serializer::COMPACT, Serializer::format() );
+
+    // Construct an array of base class objects. Leave one without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> objects( 4 );
+    objects[0] = *( builder->create("one") );
+    objects[1] = *( builder->create("two") );
+    objects[3] = *( builder->create("one") );
+    objects[0].setData( 3.0 );
+    objects[1].setData( 4.0 );
+    objects[3].setData( 5.0 );
+
+    // Each record only uses the byte size of its own derived class. Packed
+    // buffers begin with the format tag and key size.
+    int bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(std::size_t) + 
+		   4*sizeof(int) + 4*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+
+    // Serialize the objects.
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( Serializer::COMPACT, 
+		   Serializer::packedFormat(buffer.getRawPtr()) );
+
+    // Deserialize the objects. The buffer is read with the format in its
+    // header even if the format setting has changed.
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+    int count = Serializer::fromPackedBytesToCount( 
+	bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( count, objects.size() );
+    Teuchos::Array<BaseClass> received( count );
+    Serializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+
+    // Check the objects.
+    TEST_EQUALITY( 1, received[0].myNumber() );
+    TEST_EQUALITY( 1, received[0].myData().size() );
+    TEST_EQUALITY( 3.0, received[0].myData()[0] );
+
+    TEST_EQUALITY( 2, received[1].myNumber() );
+    TEST_EQUALITY( 2, received[1].myData().size() );
+    TEST_EQUALITY( 4.0, received[1].myData()[0] );
+    TEST_EQUALITY( 4.0, received[1].myData()[1] );
+
+    TEST_ASSERT( !received[2].isImplNonnull() );
+
+    TEST_EQUALITY( 1, received[3].myNumber() );
+    TEST_EQUALITY( 1, received[3].myData().size() );
+    TEST_EQUALITY( 5.0, received[3].myData()[0] );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, compact_broadcast )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::COMPACT );
+
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_default = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm_default->getRank();
+
+    // Construct an array of base class objects on the root. The other
+    // processes only have default constructed objects.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> objects( 3 );
+    if ( comm_rank == 0 )
+    {
+	objects[0] = *( builder->create("two") );
+	objects[2] = *( builder->create("one") );
+	objects[0].setData( 3.0 );
+	objects[2].setData( 4.0 );
+    }
+
+    // The traits size the buffer from the number of objects only.
+    Teuchos::Array<BaseClass> defaults( 3 );
+    TEST_EQUALITY( 
+	Serializer::fromCountToIndirectBytes( 
+	    objects.size(), objects.getRawPtr() ),
+	Serializer::fromCountToIndirectBytes( 
+	    defaults.size(), defaults.getRawPtr() ) );
+
+    // Broadcast the objects.
+    Teuchos::broadcast( *comm_default, 0, objects() );
+
+    // Check the objects.
+    TEST_EQUALITY( 2, objects[0].myNumber() );
+    TEST_EQUALITY( 2, objects[0].myData().size() );
+    TEST_EQUALITY( 3.0, objects[0].myData()[0] );
+    TEST_EQUALITY( 3.0, objects[0].myData()[1] );
+
+    TEST_ASSERT( !objects[1].isImplNonnull() );
+
+    TEST_EQUALITY( 1, objects[2].myNumber() );
+    TEST_EQUALITY( 1, objects[2].myData().size() );
+    TEST_EQUALITY( 4.0, objects[2].myData()[0] );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, grouped_deserialization )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setGroupedDeserialization( true );
+    TEST_ASSERT( Serializer::groupedDeserialization() );
+
+    // Construct an array of interleaved base class objects. Leave some
+    // without an implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 10;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	if ( i % 3 != 2 )
+	{
+	    objects[i] = *( builder->create( (i%3) ? "two" : "one" ) );
+	    objects[i].setData( i );
+	}
+    }
+
+    // Check both wire formats.
+    Serializer::Format formats[2] = { Serializer::FIXED_STRIDE, 
+				      Serializer::COMPACT };
+    for ( int f = 0; f < 2; ++f )
+    {
+	Serializer::setFormat( formats[f] );
+
+	// Serialize the objects.
+	int bytes = Serializer::fromCountToPackedBytes( 
+	    objects.size(), objects.getRawPtr() );
+	Teuchos::Array<char> buffer( bytes );
+	Serializer::serializePacked( 
+	    objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+	// Deserialize the objects.
+	int count = Serializer::fromPackedBytesToCount( 
+	    bytes, buffer.getRawPtr() );
+	TEST_EQUALITY( count, num_objects );
+	Teuchos::Array<BaseClass> received( count );
+	received[2] = *( builder->create("one") );
+	Serializer::deserializePacked( 
+	    bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+
+	// Check that the objects are in their original order.
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    if ( i % 3 == 2 )
+	    {
+		TEST_ASSERT( !received[i].isImplNonnull() );
+	    }
+	    else
+	    {
+		int number = (i%3) ? 2 : 1;
+		TEST_EQUALITY( number, received[i].myNumber() );
+		TEST_EQUALITY( number, received[i].myData().size() );
+		TEST_EQUALITY( 1.0*i, received[i].myData()[number-1] );
+	    }
+	}
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+    Serializer::setGroupedDeserialization( false );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, pooled_deserialization )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes and turn on the object pool.
+    registerDerivedClasses();
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    builder->setPooling( true );
+    int key_1 = builder->getIntegralKey( "one" );
+    int key_2 = builder->getIntegralKey( "two" );
+
+    // Serialize an array of base class objects.
+    Teuchos::Array<BaseClass> objects( 3 );
+    objects[0] = *( builder->create("two") );
+    objects[1] = *( builder->create("one") );
+    objects[0].setData( 3.0 );
+    objects[1].setData( 4.0 );
+    int bytes = Serializer::fromCountToIndirectBytes( 
+	objects.size(), objects.getRawPtr() );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serialize( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+    // Deserialize into objects of other derived classes. The replaced objects
+    // go to the pool and are reused before new objects are built.
+    Teuchos::Array<BaseClass> received( 3 );
+    received[0] = *( builder->create("one") );
+    received[1] = *( builder->create("two") );
+    received[2] = *( builder->create("one") );
+    Serializer::deserialize( 
+	bytes, buffer.getRawPtr(), objects.size(), received.getRawPtr() );
+    TEST_EQUALITY( 1, builder->poolSize(key_1) );
+    TEST_EQUALITY( 1, builder->poolSize(key_2) );
+
+    // Check the objects.
+    TEST_EQUALITY( 2, received[0].myNumber() );
+    TEST_EQUALITY( 3.0, received[0].myData()[1] );
+    TEST_EQUALITY( 1, received[1].myNumber() );
+    TEST_EQUALITY( 4.0, received[1].myData()[0] );
+    TEST_ASSERT( !received[2].isImplNonnull() );
+
+    // Deserializing the same records again only uses the pool.
+    Teuchos::Array<BaseClass> swapped( 2 );
+    swapped[0] = *( builder->create("one") );
+    swapped[1] = *( builder->create("two") );
+    Serializer::deserialize( 
+	bytes, buffer.getRawPtr(), objects.size(), received.getRawPtr() );
+    Serializer::deserialize( 
+	2*bytes/3, buffer.getRawPtr(), 2, swapped.getRawPtr() );
+    TEST_EQUALITY( 2, swapped[0].myNumber() );
+    TEST_EQUALITY( 1, swapped[1].myNumber() );
+    TEST_EQUALITY( 1, builder->poolSize(key_1) );
+    TEST_EQUALITY( 1, builder->poolSize(key_2) );
+
+    // Turning the pool off empties it.
+    builder->setPooling( false );
+    TEST_EQUALITY( 0, builder->poolSize(key_1) );
+    TEST_EQUALITY( 0, builder->poolSize(key_2) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, pooled_shared_objects )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes and turn on the object pool.
+    registerDerivedClasses();
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    builder->setPooling( true );
+    int key_1 = builder->getIntegralKey( "one" );
+    int key_2 = builder->getIntegralKey( "two" );
+
+    // Serialize two objects of the same derived class.
+    Teuchos::Array<BaseClass> objects( 2 );
+    objects[0] = *( builder->create("two") );
+    objects[1] = *( builder->create("two") );
+    objects[0].setData( 3.0 );
+    objects[1].setData( 4.0 );
+    int bytes = Serializer::fromCountToIndirectBytes( 
+	objects.size(), objects.getRawPtr() );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serialize( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+    // Deserialize over objects of another derived class and keep a copy of
+    // one of them. Only the object that is not shared goes to the pool.
+    Teuchos::Array<BaseClass> received( 2 );
+    received[0] = *( builder->create("one") );
+    received[1] = *( builder->create("one") );
+    received[0].setData( 5.0 );
+    BaseClass copy = received[0];
+    Serializer::deserialize( 
+	bytes, buffer.getRawPtr(), objects.size(), received.getRawPtr() );
+    TEST_EQUALITY( 1, builder->poolSize(key_1) );
+    TEST_EQUALITY( 0, builder->poolSize(key_2) );
+
+    // Deserialize new objects of the first derived class. They take the
+    // pooled object and the copy is not changed.
+    BaseClass one = *( builder->create("one") );
+    one.setData( 6.0 );
+    int one_bytes = Serializer::fromCountToIndirectBytes( 1, &one );
+    Teuchos::Array<char> one_buffer( one_bytes );
+    Serializer::serialize( 1, &one, one_bytes, one_buffer.getRawPtr() );
+    Serializer::deserialize( 
+	one_bytes, one_buffer.getRawPtr(), 1, &received[0] );
+    Serializer::deserialize( 
+	one_bytes, one_buffer.getRawPtr(), 1, &received[1] );
+    TEST_EQUALITY( 0, builder->poolSize(key_1) );
+    TEST_EQUALITY( 2, builder->poolSize(key_2) );
+    TEST_EQUALITY( 6.0, received[0].myData()[0] );
+    TEST_EQUALITY( 6.0, received[1].myData()[0] );
+    TEST_EQUALITY( 1, copy.myNumber() );
+    TEST_EQUALITY( 5.0, copy.myData()[0] );
+
+    builder->setPooling( false );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, in_place_deserialization )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+
+    // Serialize an array of base class objects.
+    Teuchos::Array<BaseClass> objects( 2 );
+    objects[0] = *( builder->create("one") );
+    objects[1] = *( builder->create("two") );
+    objects[0].setData( 3.0 );
+    objects[1].setData( 4.0 );
+    int bytes = Serializer::fromCountToIndirectBytes( 
+	objects.size(), objects.getRawPtr() );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serialize( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+    // Without in-place deserialization the objects are rebuilt and copies of
+    // the received objects keep their data.
+    Teuchos::Array<BaseClass> received( 2 );
+    received[0] = *( builder->create("one") );
+    received[1] = *( builder->create("one") );
+    received[0].setData( 1.0 );
+    BaseClass copy_0 = received[0];
+    TEST_ASSERT( !Serializer::inPlaceDeserialization() );
+    Serializer::deserialize( 
+	bytes, buffer.getRawPtr(), objects.size(), received.getRawPtr() );
+    TEST_EQUALITY( 3.0, received[0].myData()[0] );
+    TEST_EQUALITY( 1.0, copy_0.myData()[0] );
+
+    // With in-place deserialization objects of the same derived class are
+    // deserialized directly and copies see the new data. Objects of other
+    // derived classes are still rebuilt.
+    Serializer::setInPlaceDeserialization( true );
+    TEST_ASSERT( Serializer::inPlaceDeserialization() );
+    received[0] = copy_0;
+    received[1] = *( builder->create("one") );
+    BaseClass copy_1 = received[1];
+    Serializer::deserialize( 
+	bytes, buffer.getRawPtr(), objects.size(), received.getRawPtr() );
+    TEST_EQUALITY( 1, received[0].myNumber() );
+    TEST_EQUALITY( 3.0, received[0].myData()[0] );
+    TEST_EQUALITY( 3.0, copy_0.myData()[0] );
+    TEST_EQUALITY( 2, received[1].myNumber() );
+    TEST_EQUALITY( 4.0, received[1].myData()[1] );
+    TEST_EQUALITY( 1, copy_1.myNumber() );
+
+    Serializer::setInPlaceDeserialization( false );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, homogeneous_serializer )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,SingleBaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::HOMOGENEOUS );
+    TEST_EQUALITY( Serializer::HOMOGENEOUS, Serializer::format() );
+
+    // Construct an array of base class objects.
+    Teuchos::RCP<AbstractBuilder<SingleBaseClass> > builder = 
+	SingleBaseClass::getBuilder();
+    int num_objects = 5;
+    Teuchos::Array<SingleBaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	objects[i] = *( builder->create("two") );
+	objects[i].setData( 1.0*i );
+    }
+
+    // The buffer is the format tag, the key and number of objects followed
+    // by the object data.
+    int bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    std::size_t header = 
+	2*sizeof(unsigned char) + sizeof(int) + sizeof(std::size_t);
+    TEST_EQUALITY( header + num_objects*2*sizeof(double), 
+		   Teuchos::as<std::size_t>(bytes) );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	double data = 0.0;
+	std::memcpy( &data, &buffer[header + 2*i*sizeof(double)], 
+		     sizeof(double) );
+	TEST_EQUALITY( 1.0*i, data );
+    }
+
+    // Deserialize the objects.
+    int count = Serializer::fromPackedBytesToCount( 
+	bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( count, num_objects );
+    Teuchos::Array<SingleBaseClass> received( count );
+    Serializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	TEST_EQUALITY( 2, received[i].myNumber() );
+	TEST_EQUALITY( 1.0*i, received[i].myData()[0] );
+	TEST_EQUALITY( 1.0*i, received[i].myData()[1] );
+    }
+
+    // Batches with an object without an implementation use compact records.
+    objects[1] = SingleBaseClass();
+    bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(int) + sizeof(std::size_t) + 
+		   num_objects*sizeof(int) + (num_objects-1)*2*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+    buffer.resize( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+    Serializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+    TEST_ASSERT( !received[1].isImplNonnull() );
+    TEST_EQUALITY( 4.0, received[4].myData()[1] );
+
+    // Batches with more than one derived class use compact records.
+    typedef AbstractSerializer<int,BaseClass> MultipleSerializer;
+    MultipleSerializer::setFormat( MultipleSerializer::HOMOGENEOUS );
+    Teuchos::Array<BaseClass> multiple_objects( 2 );
+    multiple_objects[0] = *( BaseClass::getBuilder()->create("one") );
+    multiple_objects[1] = *( BaseClass::getBuilder()->create("two") );
+    multiple_objects[0].setData( 3.0 );
+    multiple_objects[1].setData( 4.0 );
+    bytes = MultipleSerializer::fromCountToPackedBytes( 
+	multiple_objects.size(), multiple_objects.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(std::size_t) + 
+		   3*sizeof(int) + 3*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+    buffer.resize( bytes );
+    MultipleSerializer::serializePacked( multiple_objects.size(), 
+					 multiple_objects.getRawPtr(), 
+					 bytes, buffer.getRawPtr() );
+    Teuchos::Array<BaseClass> multiple_received( 2 );
+    MultipleSerializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), 2, multiple_received.getRawPtr() );
+    TEST_EQUALITY( 1, multiple_received[0].myNumber() );
+    TEST_EQUALITY( 3.0, multiple_received[0].myData()[0] );
+    TEST_EQUALITY( 2, multiple_received[1].myNumber() );
+    TEST_EQUALITY( 4.0, multiple_received[1].myData()[1] );
+
+    // Batches of one derived class of a base with several derived classes
+    // are homogeneous.
+    multiple_objects[0] = *( BaseClass::getBuilder()->create("two") );
+    bytes = MultipleSerializer::fromCountToPackedBytes( 
+	multiple_objects.size(), multiple_objects.getRawPtr() );
+    TEST_EQUALITY( header + 4*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+    MultipleSerializer::setFormat( MultipleSerializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, homogeneous_bitwise )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,Point> Serializer;
+
+    // Register the point class.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::HOMOGENEOUS );
+
+    // Construct an array of points.
+    int num_points = 10;
+    Teuchos::Array<Point> points( num_points );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	points[i].x = 1.0*i;
+	points[i].y = -1.0*i;
+    }
+
+    // The points are copied as one block.
+    num_point_serializations = 0;
+    int bytes = Serializer::fromCountToPackedBytes( 
+	points.size(), points.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(int) + sizeof(std::size_t) + 
+		   num_points*sizeof(Point),
+		   Teuchos::as<std::size_t>(bytes) );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	points.size(), points.getRawPtr(), bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( 0, num_point_serializations );
+
+    // Deserialize the points.
+    int count = Serializer::fromPackedBytesToCount( 
+	bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( count, num_points );
+    Teuchos::Array<Point> received( count );
+    Serializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+    for ( int i = 0; i < num_points; ++i )
+    {
+	TEST_EQUALITY( 1.0*i, received[i].x );
+	TEST_EQUALITY( -1.0*i, received[i].y );
+    }
+
+    // Other formats serialize each point.
+    Serializer::setFormat( Serializer::COMPACT );
+    bytes = Serializer::fromCountToPackedBytes( 
+	points.size(), points.getRawPtr() );
+    buffer.resize( bytes );
+    Serializer::serializePacked( 
+	points.size(), points.getRawPtr(), bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( num_points, num_point_serializations );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, parallel_packing )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Construct an array of base class objects. Leave some without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 100;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	if ( i % 3 != 2 )
+	{
+	    objects[i] = *( builder->create( (i%3) ? "two" : "one" ) );
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // Check each format.
+    Teuchos::Array<Serializer::Format> formats( 4 );
+    formats[0] = Serializer::FIXED_STRIDE;
+    formats[1] = Serializer::COMPACT;
+    formats[2] = Serializer::RUN_LENGTH;
+    formats[3] = Serializer::HOMOGENEOUS;
+    for ( int f = 0; f < formats.size(); ++f )
+    {
+	Serializer::setFormat( formats[f] );
+	int bytes = Serializer::fromCountToPackedBytes( 
+	    objects.size(), objects.getRawPtr() );
+
+	// Serialize the objects in serial and in parallel.
+	Teuchos::Array<char> serial_buffer( bytes );
+	Serializer::serializePacked( objects.size(), objects.getRawPtr(), 
+				     bytes, serial_buffer.getRawPtr() );
+	Serializer::setParallelPacking( true );
+	TEST_ASSERT( Serializer::parallelPacking() );
+	Teuchos::Array<char> buffer( bytes );
+	Serializer::serializePacked( 
+	    objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+	// The buffers are identical.
+	TEST_COMPARE_ARRAYS( serial_buffer, buffer );
+
+	// Deserialize the objects in parallel.
+	int count = Serializer::fromPackedBytesToCount( 
+	    bytes, buffer.getRawPtr() );
+	TEST_EQUALITY( count, num_objects );
+	Teuchos::Array<BaseClass> received( count );
+	received[2] = *( builder->create("one") );
+	Serializer::deserializePacked( 
+	    bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+	Serializer::setParallelPacking( false );
+
+	// Check the objects.
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    if ( i % 3 == 2 )
+	    {
+		TEST_ASSERT( !received[i].isImplNonnull() );
+	    }
+	    else
+	    {
+		int number = (i%3) ? 2 : 1;
+		TEST_EQUALITY( number, received[i].myNumber() );
+		TEST_EQUALITY( number, received[i].myData().size() );
+		TEST_EQUALITY( 1.0*i, received[i].myData()[number-1] );
+	    }
+	}
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+// Chunk consumer that keeps a copy of every chunk.
+class ChunkStore
+{
+  public:
+    ChunkStore( Teuchos::Array<Teuchos::Array<char> >& chunks )
+	: d_chunks( chunks ) { /* ... */ }
+    void operator()( const Teuchos::ArrayView<const char>& chunk )
+    { d_chunks.push_back( Teuchos::Array<char>(chunk.begin(),chunk.end()) ); }
+  private:
+    Teuchos::Array<Teuchos::Array<char> >& d_chunks;
+};
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, chunked_serializer )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Construct an array of base class objects. Leave some without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 100;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	if ( i % 3 != 2 )
+	{
+	    objects[i] = *( builder->create( (i%3) ? "two" : "one" ) );
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // Check each format.
+    Teuchos::Array<Serializer::Format> formats( 4 );
+    formats[0] = Serializer::FIXED_STRIDE;
+    formats[1] = Serializer::COMPACT;
+    formats[2] = Serializer::RUN_LENGTH;
+    formats[3] = Serializer::HOMOGENEOUS;
+    std::size_t chunk_bytes = 128;
+    for ( int f = 0; f < formats.size(); ++f )
+    {
+	Serializer::setFormat( formats[f] );
+
+	// Serialize the objects in chunks.
+	Teuchos::Array<Teuchos::Array<char> > chunks;
+	Serializer::serializeChunked( objects.size(), objects.getRawPtr(),
+				      chunk_bytes, ChunkStore(chunks) );
+	TEST_ASSERT( chunks.size() > 1 );
+
+	// Deserialize the chunks in order.
+	Teuchos::Array<BaseClass> received( num_objects );
+	int offset = 0;
+	for ( int c = 0; c < chunks.size(); ++c )
+	{
+	    TEST_ASSERT( Teuchos::as<std::size_t>(chunks[c].size()) <= 
+			 chunk_bytes );
+	    offset += Serializer::deserializeChunk( 
+		chunks[c](), received.getRawPtr() + offset );
+	}
+	TEST_EQUALITY( offset, num_objects );
+
+	// Check the objects.
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    if ( i % 3 == 2 )
+	    {
+		TEST_ASSERT( !received[i].isImplNonnull() );
+	    }
+	    else
+	    {
+		int number = (i%3) ? 2 : 1;
+		TEST_EQUALITY( number, received[i].myNumber() );
+		TEST_EQUALITY( number, received[i].myData().size() );
+		TEST_EQUALITY( 1.0*i, received[i].myData()[number-1] );
+	    }
+	}
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, delta_serializer )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    TEST_ASSERT( 
+	HasObjectVersion<AbstractSerializableObjectPolicy<BaseClass> >::value );
+    TEST_ASSERT( !HasObjectVersion<
+		 AbstractSerializableObjectPolicy<SingleBaseClass> >::value );
+
+    // Construct an array of base class objects. Leave one without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> objects( 5 );
+    objects[0] = *( builder->create("one") );
+    objects[1] = *( builder->create("two") );
+    objects[3] = *( builder->create("one") );
+    objects[4] = *( builder->create("two") );
+    for ( int i = 0; i < objects.size(); ++i )
+    {
+	if ( objects[i].isImplNonnull() )
+	{
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // The receiver starts with default constructed objects so the object
+    // without an implementation is not sent.
+    Teuchos::Array<std::size_t> versions( objects.size(), 
+					  Serializer::nullVersion() );
+    Teuchos::Array<BaseClass> received( objects.size() );
+    int bytes = Serializer::fromCountToDeltaBytes( 
+	objects.size(), objects.getRawPtr(), versions() );
+    TEST_EQUALITY( sizeof(unsigned char) + sizeof(std::size_t) + 
+		   4*(sizeof(std::size_t)+sizeof(int)) + 6*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializeDelta( objects.size(), objects.getRawPtr(), 
+				versions(), bytes, buffer.getRawPtr() );
+    Serializer::deserializeDelta( 
+	bytes, buffer.getRawPtr(), received.size(), received.getRawPtr() );
+    for ( int i = 0; i < objects.size(); ++i )
+    {
+	TEST_EQUALITY( objects[i].isImplNonnull(), 
+		       received[i].isImplNonnull() );
+	if ( objects[i].isImplNonnull() )
+	{
+	    TEST_EQUALITY( objects[i].myNumber(), received[i].myNumber() );
+	    TEST_EQUALITY( 1.0*i, received[i].myData()[0] );
+	}
+    }
+
+    // Nothing changed.
+    bytes = Serializer::fromCountToDeltaBytes( 
+	objects.size(), objects.getRawPtr(), versions() );
+    TEST_EQUALITY( sizeof(unsigned char) + sizeof(std::size_t), 
+		   Teuchos::as<std::size_t>(bytes) );
+
+    // Change the data of one object, the derived class of another and
+    // remove the implementation of a third.
+    objects[1].setData( 7.0 );
+    objects[3] = *( builder->create("two") );
+    objects[3].setData( 8.0 );
+    objects[4] = BaseClass();
+    bytes = Serializer::fromCountToDeltaBytes( 
+	objects.size(), objects.getRawPtr(), versions() );
+    TEST_EQUALITY( sizeof(unsigned char) + sizeof(std::size_t) + 
+		   3*(sizeof(std::size_t)+sizeof(int)) + 4*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+    buffer.resize( bytes );
+    Serializer::serializeDelta( objects.size(), objects.getRawPtr(), 
+				versions(), bytes, buffer.getRawPtr() );
+
+    // Objects that keep their derived class are patched in place.
+    BaseClass copy_1 = received[1];
+    Serializer::deserializeDelta( 
+	bytes, buffer.getRawPtr(), received.size(), received.getRawPtr() );
+    TEST_EQUALITY( 7.0, copy_1.myData()[0] );
+    TEST_EQUALITY( 7.0, received[1].myData()[1] );
+    TEST_EQUALITY( 2, received[3].myNumber() );
+    TEST_EQUALITY( 8.0, received[3].myData()[1] );
+    TEST_ASSERT( !received[4].isImplNonnull() );
+    TEST_EQUALITY( 0.0, received[0].myData()[0] );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, narrow_keys )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::COMPACT );
+    Serializer::setNarrowKeys( true );
+    TEST_ASSERT( Serializer::narrowKeys() );
+
+    // Construct an array of base class objects. Leave one without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    Teuchos::Array<BaseClass> objects( 4 );
+    objects[0] = *( builder->create("one") );
+    objects[1] = *( builder->create("two") );
+    objects[3] = *( builder->create("one") );
+    objects[0].setData( 3.0 );
+    objects[1].setData( 4.0 );
+    objects[3].setData( 5.0 );
+
+    // Two derived classes only need single byte keys.
+    int bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(std::size_t) + 
+		   4*sizeof(char) + 4*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+
+    // Serialize the objects. The key size is written into the header.
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( sizeof(signed char), 
+		   Serializer::packedKeyByteSize(buffer.getRawPtr()) );
+
+    // Deserialize the objects. The buffer is read with the key size in its
+    // header even if the receiver does not narrow its keys.
+    Serializer::setNarrowKeys( false );
+    int count = Serializer::fromPackedBytesToCount( 
+	bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( count, objects.size() );
+    Teuchos::Array<BaseClass> received( count );
+    Serializer::deserializePacked( 
+	bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+
+    // Check the objects.
+    TEST_EQUALITY( 1, received[0].myNumber() );
+    TEST_EQUALITY( 3.0, received[0].myData()[0] );
+    TEST_EQUALITY( 2, received[1].myNumber() );
+    TEST_EQUALITY( 4.0, received[1].myData()[1] );
+    TEST_ASSERT( !received[2].isImplNonnull() );
+    TEST_EQUALITY( 1, received[3].myNumber() );
+    TEST_EQUALITY( 5.0, received[3].myData()[0] );
+
+    // Delta buffers also carry their key size.
+    Serializer::setNarrowKeys( true );
+    Teuchos::Array<std::size_t> versions( objects.size(), 
+					  Serializer::nullVersion() );
+    bytes = Serializer::fromCountToDeltaBytes( 
+	objects.size(), objects.getRawPtr(), versions() );
+    buffer.resize( bytes );
+    Serializer::serializeDelta( objects.size(), objects.getRawPtr(), 
+				versions(), bytes, buffer.getRawPtr() );
+    Serializer::setNarrowKeys( false );
+    Teuchos::Array<BaseClass> patched( objects.size() );
+    Serializer::deserializeDelta( 
+	bytes, buffer.getRawPtr(), patched.size(), patched.getRawPtr() );
+    TEST_EQUALITY( 2, patched[1].myNumber() );
+    TEST_EQUALITY( 4.0, patched[1].myData()[1] );
+    TEST_EQUALITY( 5.0, patched[3].myData()[0] );
+
+    Serializer::setNarrowKeys( false );
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, run_length_serializer )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::RUN_LENGTH );
+    TEST_EQUALITY( Serializer::RUN_LENGTH, Serializer::format() );
+
+    // Construct an array of base class objects sorted by derived class with
+    // the objects without an implementation last.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_one = 6;
+    int num_two = 4;
+    int num_null = 2;
+    int num_objects = num_one + num_two + num_null;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    for ( int i = 0; i < num_one + num_two; ++i )
+    {
+	objects[i] = *( builder->create( (i < num_one) ? "one" : "two" ) );
+	objects[i].setData( 1.0*i );
+    }
+
+    // Each run has one key and length.
+    int bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(std::size_t) + 
+		   3*(sizeof(int) + sizeof(std::size_t)) +
+		   (num_one + 2*num_two)*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+
+    // Serialize the objects.
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+
+    // Deserialize the objects in order and grouped.
+    int count = Serializer::fromPackedBytesToCount( 
+	bytes, buffer.getRawPtr() );
+    TEST_EQUALITY( count, num_objects );
+    for ( int g = 0; g < 2; ++g )
+    {
+	Serializer::setGroupedDeserialization( 1 == g );
+	Teuchos::Array<BaseClass> received( count );
+	Serializer::deserializePacked( 
+	    bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+
+	// Check the objects.
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    if ( i >= num_one + num_two )
+	    {
+		TEST_ASSERT( !received[i].isImplNonnull() );
+	    }
+	    else
+	    {
+		int number = (i < num_one) ? 1 : 2;
+		TEST_EQUALITY( number, received[i].myNumber() );
+		TEST_EQUALITY( number, received[i].myData().size() );
+		TEST_EQUALITY( 1.0*i, received[i].myData()[number-1] );
+	    }
+	}
+    }
+    Serializer::setGroupedDeserialization( false );
+
+    // Narrow keys shrink the run headers.
+    Serializer::setNarrowKeys( true );
+    TEST_EQUALITY( bytes - 3*(sizeof(int) - sizeof(char)),
+		   Teuchos::as<std::size_t>(
+		       Serializer::fromCountToPackedBytes( 
+			   objects.size(), objects.getRawPtr())) );
+    Serializer::setNarrowKeys( false );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, run_length_broadcast )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::RUN_LENGTH );
+
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_default = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm_default->getRank();
+
+    // Construct runs of base class objects on the root. The other processes
+    // only have default constructed objects.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int num_objects = 6;
+    Teuchos::Array<BaseClass> objects( num_objects );
+    if ( comm_rank == 0 )
+    {
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    objects[i] = *( builder->create( (i < 4) ? "one" : "two" ) );
+	    objects[i].setData( 1.0*i );
+	}
+    }
+
+    // The traits size the buffer from the number of objects only.
+    Teuchos::Array<BaseClass> defaults( num_objects );
+    TEST_EQUALITY( 
+	Serializer::fromCountToIndirectBytes( 
+	    objects.size(), objects.getRawPtr() ),
+	Serializer::fromCountToIndirectBytes( 
+	    defaults.size(), defaults.getRawPtr() ) );
+
+    // Broadcast the objects.
+    Teuchos::broadcast( *comm_default, 0, objects() );
+
+    // Check the objects.
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	int number = (i < 4) ? 1 : 2;
+	TEST_EQUALITY( number, objects[i].myNumber() );
+	TEST_EQUALITY( 1.0*i, objects[i].myData()[number-1] );
+    }
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, integral_key_cache )
+{
+    using namespace Bricks;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // The base class policy caches the integral keys of its derived classes.
+    TEST_ASSERT( HasObjectIntegralKey<
+		 AbstractBuildableObjectPolicy<BaseClass> >::value );
+    TEST_ASSERT( !HasObjectIntegralKey<
+		 AbstractBuildableObjectPolicy<SingleBaseClass> >::value );
+
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    TEST_EQUALITY( builder->getIntegralKey("one"), 
+		   BaseClass::integralKey<MyNumberIsOne>() );
+    TEST_EQUALITY( builder->getIntegralKey("two"), 
+		   BaseClass::integralKey<MyNumberIsTwo>() );
+
+    BaseClass object = *( builder->create("two") );
+    TEST_EQUALITY( builder->getIntegralKey("two"),
+		   AbstractBuildableObjectPolicy<BaseClass>::objectIntegralKey(
+		       object) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, registry_tables )
+{
+    using namespace Bricks;
+    typedef AbstractObjectRegistry<BaseClass,MyNumberIsOne,MyNumberIsTwo>
+	Registry;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // The list of derived classes is kept at compile time.
+    TEST_EQUALITY( 2, Registry::num_derived_types );
+    TEST_EQUALITY( 0, Registry::index<MyNumberIsOne>() );
+    TEST_EQUALITY( 1, Registry::index<MyNumberIsTwo>() );
+    TEST_ASSERT( (std::is_same<Registry::derived_type<1>::type,
+				MyNumberIsTwo>::value) );
+    TEST_ASSERT( (std::is_same<Registry::derived_type_1,
+				MyNumberIsOne>::value) );
+    TEST_ASSERT( (std::is_same<Registry::derived_type_2,
+				MyNumberIsTwo>::value) );
+    TEST_ASSERT( (std::is_same<Registry::derived_type_3,void>::value) );
+
+    // Registration maps the integral keys to the positions.
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    for ( int i = 0; i < Registry::num_derived_types; ++i )
+    {
+	TEST_EQUALITY( i, Registry::position(
+			   builder->getIntegralKey(Registry::objectType(i))) );
+	BaseClass object;
+	Registry::create( i, object );
+	TEST_EQUALITY( i+1, object.myNumber() );
+	TEST_EQUALITY( (i+1)*sizeof(double), Registry::byteSize(i) );
+	TEST_EQUALITY( BaseClass::derivedClassByteSize(i), 
+		       Registry::byteSize(i) );
+    }
+
+    // Serializers of the base class create objects through the registry.
+    TEST_ASSERT( 
+	HasRegistryType<AbstractSerializableObjectPolicy<BaseClass> >::value );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, registry_positions )
+{
+    using namespace Bricks;
+    typedef AbstractObjectRegistry<BaseClass,MyNumberIsTwo,MyNumberIsOne>
+	Registry;
+
+    // Register derived classes.
+    registerDerivedClasses();
+    Teuchos::RCP<AbstractBuilder<BaseClass> > builder = BaseClass::getBuilder();
+    int key_one = builder->getIntegralKey( "one" );
+    int key_two = builder->getIntegralKey( "two" );
+
+    // Integral keys have no position until the registry maps them.
+    TEST_EQUALITY( -1, Registry::position(key_one) );
+    TEST_EQUALITY( -1, Registry::position(key_two) );
+
+    // A registry listing the derived classes in another order than they were
+    // registered with the builder maps the keys to its own positions.
+    Registry::mapIntegralKeys();
+    TEST_EQUALITY( 1, Registry::position(key_one) );
+    TEST_EQUALITY( 0, Registry::position(key_two) );
+    TEST_EQUALITY( -1, Registry::position(builder->numDerivedClasses()) );
+
+    BaseClass object;
+    Registry::create( Registry::position(key_one), object );
+    TEST_EQUALITY( 1, object.myNumber() );
+    TEST_EQUALITY( "one", object.objectType() );
+    TEST_EQUALITY( BaseClass::derivedClassByteSize(key_one),
+		   Registry::byteSize(Registry::position(key_one)) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, registry_byte_size )
+{
+    using namespace Bricks;
+    typedef AbstractObjectRegistry<BaseClass,MyNumberIsOne,MyNumberIsTwo>
+	Registry;
+
+    // The byte sizes come from the type list at compile time and do not
+    // need the derived classes to be registered.
+    static_assert( 2*sizeof(double) == Registry::maxByteSize(), 
+		   "registry maximum byte size" );
+    char buffer[ Registry::maxByteSize() ];
+    TEST_EQUALITY( sizeof(buffer), Registry::maxByteSize() );
+    TEST_EQUALITY( 2*sizeof(double), 
+		   (std::integral_constant<std::size_t,
+		    Registry::byteSize<MyNumberIsTwo>()>::value) );
+    TEST_EQUALITY( 2*sizeof(double), Registry::maxByteSize() );
+    TEST_EQUALITY( sizeof(double), Registry::byteSize<MyNumberIsOne>() );
+    TEST_EQUALITY( 2*sizeof(double), Registry::byteSize<MyNumberIsTwo>() );
+
+    // The sizes agree with the registered sizes.
+    registerDerivedClasses();
+    TEST_EQUALITY( BaseClass::maxByteSize(), Registry::maxByteSize() );
+    TEST_EQUALITY( BaseClass::derivedClassByteSize(0), 
+		   Registry::byteSize<MyNumberIsOne>() );
+
+    // Fixed stride records are sized with the registry maximum.
+    typedef AbstractSerializer<int,BaseClass> Serializer;
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+    Teuchos::Array<BaseClass> objects( 3 );
+    TEST_EQUALITY( Teuchos::as<int>(2*sizeof(unsigned char)) + 
+		   3 * Teuchos::as<int>(sizeof(int) + Registry::maxByteSize()),
+		   Serializer::fromCountToPackedBytes( 3, objects.getRawPtr() ) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, object_byte_size )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,TallyBaseClass> Serializer;
+
+    // Register derived classes.
+    registerDerivedClasses();
+
+    // Construct an array of tallies of different sizes. Leave one without an
+    // implementation.
+    Teuchos::RCP<AbstractBuilder<TallyBaseClass> > builder = 
+	TallyBaseClass::getBuilder();
+    Teuchos::Array<TallyBaseClass> objects( 4 );
+    objects[0] = *( builder->create("tally") );
+    objects[1] = *( builder->create("tally") );
+    objects[3] = *( builder->create("tally") );
+    objects[0].setData( 1, 1.0 );
+    objects[1].setData( 5, 2.0 );
+    objects[3].setData( 3, 3.0 );
+
+    // Every record is sized exactly in each format. The homogeneous format
+    // falls back to the compact format.
+    Serializer::Format formats[3] = 
+	{ Serializer::COMPACT, Serializer::RUN_LENGTH, Serializer::HOMOGENEOUS };
+    for ( int f = 0; f < 3; ++f )
+    {
+	for ( int p = 0; p < 2; ++p )
+	{
+	    Serializer::setFormat( formats[f] );
+	    Serializer::setParallelPacking( 1 == p );
+	    Serializer::setGroupedDeserialization( 1 == p );
+
+	    int bytes = Serializer::fromCountToPackedBytes( 
+		objects.size(), objects.getRawPtr() );
+	    std::size_t key_bytes = ( Serializer::RUN_LENGTH == formats[f] )
+				    ? 3*(sizeof(int) + sizeof(std::size_t))
+				    : 4*sizeof(int);
+	    TEST_EQUALITY( 2*sizeof(unsigned char) + sizeof(std::size_t) + 
+			   key_bytes + 3*sizeof(std::size_t) + 9*sizeof(double),
+			   Teuchos::as<std::size_t>(bytes) );
+
+	    Teuchos::Array<char> buffer( bytes );
+	    Serializer::serializePacked( 
+		objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+	    int count = Serializer::fromPackedBytesToCount( 
+		bytes, buffer.getRawPtr() );
+	    TEST_EQUALITY( count, objects.size() );
+	    Teuchos::Array<TallyBaseClass> received( count );
+	    Serializer::deserializePacked( 
+		bytes, buffer.getRawPtr(), count, received.getRawPtr() );
+
+	    TEST_EQUALITY( 1, received[0].myData().size() );
+	    TEST_EQUALITY( 1.0, received[0].myData()[0] );
+	    TEST_EQUALITY( 5, received[1].myData().size() );
+	    TEST_EQUALITY( 2.0, received[1].myData()[4] );
+	    TEST_ASSERT( !received[2].isImplNonnull() );
+	    TEST_EQUALITY( 3, received[3].myData().size() );
+	    TEST_EQUALITY( 3.0, received[3].myData()[2] );
+	}
+    }
+    Serializer::setParallelPacking( false );
+    Serializer::setGroupedDeserialization( false );
+
+    // Records can be read one at a time.
+    Serializer::setFormat( Serializer::COMPACT );
+    int bytes = Serializer::fromCountToPackedBytes( 
+	objects.size(), objects.getRawPtr() );
+    Teuchos::Array<char> buffer( bytes );
+    Serializer::serializePacked( 
+	objects.size(), objects.getRawPtr(), bytes, buffer.getRawPtr() );
+    Serializer::Format record_layout = 
+	Serializer::packedFormat( buffer.getRawPtr() );
+    std::size_t key_size = Serializer::packedKeyByteSize( buffer.getRawPtr() );
+    const char* record = Serializer::firstRecord( buffer.getRawPtr() );
+    const char* data = NULL;
+    int integral_key = 0;
+    TallyBaseClass object;
+    record = Serializer::nextRecord( 
+	record_layout, key_size, record, integral_key, data );
+    record = Serializer::nextRecord( 
+	record_layout, key_size, record, integral_key, data );
+    Serializer::deserializeRecord( record_layout, integral_key, data, object );
+    TEST_EQUALITY( 5, object.myData().size() );
+    record = Serializer::nextRecord( 
+	record_layout, key_size, record, integral_key, data );
+    TEST_EQUALITY( -1, integral_key );
+    record = Serializer::nextRecord( 
+	record_layout, key_size, record, integral_key, data );
+    TEST_EQUALITY( buffer.getRawPtr() + bytes, record );
+
+    // Delta records are sized exactly.
+    Teuchos::Array<std::size_t> versions( 
+	objects.size(), Serializer::nullVersion() );
+    bytes = Serializer::fromCountToDeltaBytes( 
+	objects.size(), objects.getRawPtr(), versions() );
+    TEST_EQUALITY( sizeof(unsigned char) + sizeof(std::size_t) + 
+		   4*(sizeof(std::size_t)+sizeof(int)) +
+		   3*sizeof(std::size_t) + 9*sizeof(double),
+		   Teuchos::as<std::size_t>(bytes) );
+    buffer.resize( bytes );
+    Serializer::serializeDelta( objects.size(), objects.getRawPtr(), 
+				versions(), bytes, buffer.getRawPtr() );
+    Teuchos::Array<TallyBaseClass> patched( objects.size() );
+    Serializer::deserializeDelta( 
+	bytes, buffer.getRawPtr(), patched.size(), patched.getRawPtr() );
+    TEST_EQUALITY( 5, patched[1].myData().size() );
+    TEST_EQUALITY( 3.0, patched[3].myData()[0] );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AbstractSerializer, object_byte_size_broadcast )
+{
+    using namespace Bricks;
+    typedef AbstractSerializer<int,TallyBaseClass> Serializer;
+
+    // Register derived classes. The packed format does not change the
+    // traits.
+    registerDerivedClasses();
+    Serializer::setFormat( Serializer::COMPACT );
+
+    // Get the communicator.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_default = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_rank = comm_default->getRank();
+
+    // Construct tallies of different sizes on the root. The other processes
+    // only have default constructed objects.
+    Teuchos::RCP<AbstractBuilder<TallyBaseClass> > builder = 
+	TallyBaseClass::getBuilder();
+    Teuchos::Array<TallyBaseClass> objects( 3 );
+    if ( comm_rank == 0 )
+    {
+	objects[0] = *( builder->create("tally") );
+	objects[2] = *( builder->create("tally") );
+	objects[0].setData( 5, 2.0 );
+	objects[2].setData( 3, 3.0 );
+    }
+
+    // The traits size the buffer from the number of objects only and each
+    // record holds the byte size of its data.
+    Teuchos::Array<TallyBaseClass> defaults( 3 );
+    TEST_EQUALITY( 
+	3 * Teuchos::as<int>(sizeof(int) + sizeof(std::size_t) + 
+			     16*sizeof(double)),
+	Serializer::fromCountToIndirectBytes( 
+	    objects.size(), objects.getRawPtr() ) );
+    TEST_EQUALITY( 
+	Serializer::fromCountToIndirectBytes( 
+	    objects.size(), objects.getRawPtr() ),
+	Serializer::fromCountToIndirectBytes( 
+	    defaults.size(), defaults.getRawPtr() ) );
+
+    // Broadcast the objects.
+    Teuchos::broadcast( *comm_default, 0, objects() );
+
+    // Check the objects.
+    TEST_EQUALITY( 5, objects[0].myData().size() );
+    TEST_EQUALITY( 2.0, objects[0].myData()[4] );
+    TEST_ASSERT( !objects[1].isImplNonnull() );
+    TEST_EQUALITY( 3, objects[2].myData().size() );
+    TEST_EQUALITY( 3.0, objects[2].myData()[2] );
+
+    Serializer::setFormat( Serializer::FIXED_STRIDE );
 }
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,223 @@
+//----------------------------------*-C++-*----------------------------------//
+/*!
+ * \file   tstArenaAllocator.cpp
+ * \author Stuart Slattery
+ * \brief  Arena allocator class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+
+#include <Bricks_ArenaAllocator.hpp>
+#include <Bricks_AbstractBuilder.hpp>
+#include <Bricks_AbstractBuildableObject.hpp>
+
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Array.hpp"
+#include "Teuchos_AbstractFactoryStd.hpp"
+
+//---------------------------------------------------------------------------//
+// HELPER CLASSES
+//---------------------------------------------------------------------------//
+// Base class interface.
+class BaseClass : public Bricks::AbstractBuildableObject<BaseClass>
+{
+  public:
+    BaseClass() { /* ... */ }
+    virtual ~BaseClass() { /* ... */ }
+    virtual int myNumber() const = 0;
+    virtual std::string objectType() const = 0;
+};
+
+//---------------------------------------------------------------------------//
+namespace Bricks
+{
+// AbstractBuildableObjectPolicy implementation for the base class.
+template<>
+class AbstractBuildableObjectPolicy<BaseClass>
+{
+  public:
+
+    typedef BaseClass object_type;
+
+    static std::string objectType( const BaseClass& object )
+    {
+	return object.objectType();
+    }
+
+    static Teuchos::RCP<Bricks::AbstractBuilder<BaseClass> > getBuilder()
+    {
+	return BaseClass::getBuilder();
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// Derived class that counts its live objects.
+class MyNumberIsOne : public BaseClass
+{
+  public:
+    MyNumberIsOne() { ++b_num_live; ++b_num_constructed; }
+    ~MyNumberIsOne() { --b_num_live; }
+    int myNumber() const { return 1; }
+    std::string objectType() const { return std::string("one"); }
+    static int b_num_live;
+    static int b_num_constructed;
+};
+
+int MyNumberIsOne::b_num_live = 0;
+int MyNumberIsOne::b_num_constructed = 0;
+
+//---------------------------------------------------------------------------//
+namespace Bricks
+{
+// DerivedBuildableObjectPolicy implementation for the derived class.
+template<>
+class DerivedBuildableObjectPolicy<MyNumberIsOne>
+{
+  public:
+
+    typedef MyNumberIsOne object_type;
+
+    static std::string objectType()
+    {
+	return std::string("one");
+    }
+};
+} // end namespace Bricks
+
+//---------------------------------------------------------------------------//
+// TESTS
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( ArenaAllocator, allocate )
+{
+    Bricks::ArenaAllocator<MyNumberIsOne> allocator( 4 );
+    TEST_EQUALITY( 0, allocator.numObjects() );
+    TEST_EQUALITY( 0, allocator.capacity() );
+
+    // Objects are constructed next to each other in blocks.
+    int num_objects = 6;
+    Teuchos::Array<Teuchos::RCP<MyNumberIsOne> > objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	objects[i] = allocator.allocate();
+	TEST_EQUALITY( 1, objects[i]->myNumber() );
+    }
+    TEST_EQUALITY( num_objects, MyNumberIsOne::b_num_live );
+    TEST_EQUALITY( num_objects, allocator.numObjects() );
+    TEST_EQUALITY( 8, allocator.capacity() );
+    TEST_EQUALITY( objects[0].get() + 1, objects[1].get() );
+    TEST_EQUALITY( objects[4].get() + 1, objects[5].get() );
+
+    // Releasing objects destroys them but keeps their storage.
+    MyNumberIsOne* front = objects[0].get();
+    objects.resize( 1 );
+    TEST_EQUALITY( 1, MyNumberIsOne::b_num_live );
+    TEST_EQUALITY( 1, allocator.numObjects() );
+    TEST_EQUALITY( 8, allocator.capacity() );
+
+    // Once the arena is empty its storage is reused from the front.
+    objects.clear();
+    TEST_EQUALITY( 0, MyNumberIsOne::b_num_live );
+    TEST_EQUALITY( 0, allocator.numObjects() );
+    Teuchos::RCP<MyNumberIsOne> reused = allocator.allocate();
+    TEST_EQUALITY( front, reused.get() );
+    TEST_EQUALITY( 8, allocator.capacity() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( ArenaAllocator, long_lived_object )
+{
+    Bricks::ArenaAllocator<MyNumberIsOne> allocator( 4 );
+
+    // Keep one object alive while populations of short-lived objects are
+    // created and destroyed. Their storage is reused so the arena does not
+    // grow.
+    Teuchos::RCP<MyNumberIsOne> long_lived = allocator.allocate();
+    int num_objects = 7;
+    for ( int step = 0; step < 10; ++step )
+    {
+	Teuchos::Array<Teuchos::RCP<MyNumberIsOne> > objects( num_objects );
+	for ( int i = 0; i < num_objects; ++i )
+	{
+	    objects[i] = allocator.allocate();
+	}
+	TEST_EQUALITY( num_objects + 1, allocator.numObjects() );
+	TEST_EQUALITY( 8, allocator.capacity() );
+    }
+    TEST_EQUALITY( 1, allocator.numObjects() );
+    TEST_EQUALITY( 1, long_lived->myNumber() );
+
+    // Destroyed storage is reused most recent first.
+    Teuchos::RCP<MyNumberIsOne> object = allocator.allocate();
+    MyNumberIsOne* storage = object.get();
+    object = Teuchos::null;
+    object = allocator.allocate();
+    TEST_EQUALITY( storage, object.get() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( ArenaAllocator, release )
+{
+    Bricks::ArenaAllocator<MyNumberIsOne> allocator( 4 );
+    int num_objects = 9;
+    Teuchos::Array<Teuchos::RCP<MyNumberIsOne> > objects( num_objects );
+    for ( int i = 0; i < num_objects; ++i )
+    {
+	objects[i] = allocator.allocate();
+    }
+    TEST_EQUALITY( 12, allocator.capacity() );
+
+    // The blocks can only be released once all objects are destroyed.
+#if HAVE_Bricks_DBC
+    TEST_THROW( allocator.release(), Bricks::Assertion );
+    TEST_EQUALITY( 12, allocator.capacity() );
+#endif
+    objects.clear();
+    TEST_EQUALITY( 0, MyNumberIsOne::b_num_live );
+    allocator.release();
+    TEST_EQUALITY( 0, allocator.numObjects() );
+    TEST_EQUALITY( 0, allocator.capacity() );
+
+    // The arena grows again after the release.
+    Teuchos::RCP<MyNumberIsOne> object = allocator.allocate();
+    TEST_EQUALITY( 1, object->myNumber() );
+    TEST_EQUALITY( 1, allocator.numObjects() );
+    TEST_EQUALITY( 4, allocator.capacity() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( ArenaAllocator, factory )
+{
+    // Register the derived class with an arena. The derived class is named
+    // by its policy so no object is constructed.
+    int num_constructed = MyNumberIsOne::b_num_constructed;
+    Bricks::ArenaAllocator<MyNumberIsOne> allocator( 16 );
+    BaseClass::setDerivedClassFactory<MyNumberIsOne>( allocator );
+    TEST_EQUALITY( num_constructed, MyNumberIsOne::b_num_constructed );
+    TEST_EQUALITY( 0, allocator.numObjects() );
+    TEST_EQUALITY( 0, allocator.capacity() );
+    Teuchos::RCP<Bricks::AbstractBuilder<BaseClass> > builder =
+	BaseClass::getBuilder();
+    int key = builder->getIntegralKey( "one" );
+
+    // Objects created by the builder come from the arena.
+    Teuchos::RCP<BaseClass> object_1 = builder->create( key );
+    Teuchos::RCP<BaseClass> object_2 = builder->create( "one" );
+    TEST_EQUALITY( 1, object_1->myNumber() );
+    TEST_EQUALITY( 2, allocator.numObjects() );
+    TEST_EQUALITY( dynamic_cast<MyNumberIsOne*>(object_1.get()) + 1,
+		   dynamic_cast<MyNumberIsOne*>(object_2.get()) );
+
+    object_1 = Teuchos::null;
+    object_2 = Teuchos::null;
+    TEST_EQUALITY( 0, allocator.numObjects() );
+}
+
+//---------------------------------------------------------------------------//
+// end of tstArenaAllocator.cpp
+//---------------------------------------------------------------------------//
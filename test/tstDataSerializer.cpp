@@ -11,12 +11,14 @@
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 
 #include <Bricks_DataSerializer.hpp>
 
 #include "Teuchos_UnitTestHarness.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_Array.hpp"
+#include "Teuchos_ArrayRCP.hpp"
 #include "Teuchos_DefaultComm.hpp"
 #include "Teuchos_CommHelpers.hpp"
 #include "Teuchos_as.hpp"
@@ -383,6 +385,334 @@ TEUCHOS_UNIT_TEST( DataSerializer, view_broadcast_test )
     TEST_EQUALITY( ds_holder.data, data_val );
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, growable_pack_unpack_test )
+{
+    bool data_bool = true;
+    unsigned int data_uint = 1;
+    int data_int = -4;
+    float data_flt = -0.4332;
+    double data_dbl = 3.2;
+    DataHolder data_holder;
+    double data_val = 2;
+    data_holder.data = data_val;
+
+    std::size_t buffer_size = sizeof(bool) + sizeof(unsigned int) +
+			      sizeof(int) + sizeof(float) +
+			      sizeof(double) + sizeof(DataHolder);
+
+    // Start with a capacity that forces the buffer to grow.
+    Bricks::DataSerializer serializer;
+    serializer.growableBufferMode( 1 );
+    TEST_EQUALITY( serializer.size(), 0 );
+
+    serializer << data_bool << data_uint << data_int << data_flt 
+	       << data_dbl << data_holder;
+    TEST_EQUALITY( serializer.size(), buffer_size );
+    TEST_EQUALITY( serializer.end(), serializer.begin() + buffer_size );
+
+    Teuchos::ArrayView<char> buffer = serializer.getBufferView();
+    TEST_EQUALITY( Teuchos::as<std::size_t>(buffer.size()), buffer_size );
+    TEST_EQUALITY( buffer.getRawPtr(), serializer.begin() );
+
+    // Check against a buffer packed in two passes.
+    Bricks::DataSerializer two_pass_serializer;
+    two_pass_serializer.computeBufferSizeMode();
+    two_pass_serializer << data_bool << data_uint << data_int << data_flt 
+			<< data_dbl << data_holder;
+    Teuchos::Array<char> two_pass_buffer( two_pass_serializer.size() );
+    two_pass_serializer.setBuffer( two_pass_buffer() );
+    two_pass_serializer << data_bool << data_uint << data_int << data_flt 
+			<< data_dbl << data_holder;
+    TEST_EQUALITY( two_pass_buffer.size(), buffer.size() );
+    TEST_ASSERT( std::equal(buffer.begin(), buffer.end(), 
+			    two_pass_buffer.begin()) );
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setBuffer( buffer );
+
+    bool ds_bool = false;
+    unsigned int ds_uint = 0;
+    int ds_int = 0;
+    float ds_flt = 0.0;
+    double ds_dbl = 0.0;
+    DataHolder ds_holder;
+
+    deserializer >> ds_bool;
+    TEST_EQUALITY( ds_bool, data_bool );
+
+    deserializer >> ds_uint;
+    TEST_EQUALITY( ds_uint, data_uint );
+
+    deserializer >> ds_int;
+    TEST_EQUALITY( ds_int, data_int );
+
+    deserializer >> ds_flt;
+    TEST_EQUALITY( ds_flt, data_flt );
+
+    deserializer >> ds_dbl;
+    TEST_EQUALITY( ds_dbl, data_dbl );
+
+    deserializer >> ds_holder;
+    TEST_EQUALITY( ds_holder.data, data_val );
+
+    // Reusing the serializer starts a new stream in the existing buffer.
+    const char* begin = serializer.begin();
+    serializer.growableBufferMode();
+    TEST_EQUALITY( serializer.size(), 0 );
+    TEST_EQUALITY( serializer.begin(), begin );
+    serializer << data_dbl;
+    TEST_EQUALITY( serializer.size(), sizeof(double) );
+    TEST_EQUALITY( serializer.begin(), begin );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, growable_copy_test )
+{
+    int data_int = -4;
+    double data_dbl = 3.2;
+
+    // Copies of a growable serializer own their buffer.
+    Bricks::DataSerializer serializer;
+    serializer.growableBufferMode( 1 );
+    serializer << data_int;
+    Bricks::DataSerializer copy( serializer );
+    TEST_ASSERT( copy.begin() != serializer.begin() );
+    TEST_EQUALITY( copy.size(), sizeof(int) );
+    TEST_EQUALITY( copy.getPtr(), copy.begin() + sizeof(int) );
+
+    // Growing or destroying the original does not affect the copy.
+    serializer << data_dbl;
+    serializer = Bricks::DataSerializer();
+    copy << data_dbl;
+    TEST_EQUALITY( copy.size(), sizeof(int) + sizeof(double) );
+
+    // Assigned serializers also own their buffer.
+    Bricks::DataSerializer assigned;
+    assigned = copy;
+    TEST_ASSERT( assigned.begin() != copy.begin() );
+    TEST_EQUALITY( assigned.size(), copy.size() );
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setBuffer( assigned.getBufferView() );
+    int ds_int = 0;
+    double ds_dbl = 0.0;
+    deserializer >> ds_int >> ds_dbl;
+    TEST_EQUALITY( ds_int, data_int );
+    TEST_EQUALITY( ds_dbl, data_dbl );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, bulk_size_test )
+{
+    int num_data = 1000;
+    Teuchos::Array<double> data_array( num_data, 1.2 );
+    std::vector<int> data_vector( num_data, -3 );
+    Teuchos::Array<float> data_ptr( num_data, 4.5 );
+
+    std::size_t buffer_size = 3*sizeof(std::size_t) + 
+			      num_data*sizeof(double) +
+			      num_data*sizeof(int) + 
+			      num_data*sizeof(float);
+
+    Bricks::DataSerializer serializer;
+    serializer.computeBufferSizeMode();
+    serializer.pack( data_array() );
+    serializer.pack( data_vector );
+    serializer.pack( data_ptr.getRawPtr(), data_ptr.size() );
+
+    TEST_EQUALITY( serializer.size(), buffer_size );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, bulk_pack_unpack_test )
+{
+    int num_data = 1000;
+    Teuchos::Array<double> data_array( num_data );
+    std::vector<int> data_vector( num_data );
+    Teuchos::Array<float> data_ptr( num_data );
+    for ( int n = 0; n < num_data; ++n )
+    {
+	data_array[n] = 1.2 * n;
+	data_vector[n] = -3 * n;
+	data_ptr[n] = 4.5 * n;
+    }
+    Teuchos::ArrayView<const double> const_view = data_array();
+    double data_dbl = 3.2;
+
+    Bricks::DataSerializer serializer;
+    serializer.computeBufferSizeMode();
+    serializer << const_view << data_vector << data_dbl << data_array;
+    serializer.pack( data_ptr.getRawPtr(), data_ptr.size() );
+
+    Teuchos::Array<char> buffer( serializer.size() );
+    serializer.setBuffer( buffer() );
+    serializer << const_view << data_vector << data_dbl << data_array;
+    serializer.pack( data_ptr.getRawPtr(), data_ptr.size() );
+    TEST_EQUALITY( serializer.getPtr(), serializer.end() );
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setBuffer( buffer() );
+
+    Teuchos::Array<double> ds_array_view( num_data );
+    std::vector<int> ds_vector;
+    double ds_dbl = 0.0;
+    Teuchos::Array<double> ds_array;
+    Teuchos::Array<float> ds_ptr( num_data );
+
+    deserializer.unpack( ds_array_view() );
+    deserializer >> ds_vector >> ds_dbl >> ds_array;
+    deserializer.unpack( ds_ptr.getRawPtr(), ds_ptr.size() );
+    TEST_EQUALITY( deserializer.getPtr(), deserializer.end() );
+
+    TEST_EQUALITY( ds_array_view, data_array );
+    TEST_ASSERT( ds_vector == data_vector );
+    TEST_EQUALITY( ds_dbl, data_dbl );
+    TEST_EQUALITY( ds_array, data_array );
+    TEST_EQUALITY( ds_ptr, data_ptr );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, nested_bulk_pack_unpack_test )
+{
+    int num_data = 10;
+    std::vector<std::vector<double> > data( num_data );
+    for ( int n = 0; n < num_data; ++n )
+    {
+	data[n].assign( n, 1.0 * n );
+    }
+
+    Bricks::DataSerializer serializer;
+    serializer.computeBufferSizeMode();
+    serializer << data;
+    std::size_t buffer_size = (num_data+1)*sizeof(std::size_t) +
+			      (num_data*(num_data-1)/2)*sizeof(double);
+    TEST_EQUALITY( serializer.size(), buffer_size );
+
+    serializer.growableBufferMode();
+    serializer << data;
+    TEST_EQUALITY( serializer.size(), buffer_size );
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setBuffer( serializer.getBufferView() );
+    std::vector<std::vector<double> > ds_data;
+    deserializer >> ds_data;
+    TEST_ASSERT( ds_data == data );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, bulk_view_test )
+{
+    int num_data = 100;
+    Teuchos::Array<double> data( num_data );
+    for ( int n = 0; n < num_data; ++n )
+    {
+	data[n] = 1.2 * n;
+    }
+    char data_char = 'a';
+
+    // Pack the array once where it will be aligned and once where it will
+    // not.
+    Bricks::DataSerializer serializer;
+    serializer.growableBufferMode();
+    serializer << data << data_char << data;
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setBuffer( serializer.getBufferView() );
+
+    // The aligned array is viewed in place.
+    Teuchos::ArrayRCP<const double> aligned_view = deserializer.view<double>();
+    TEST_EQUALITY( aligned_view.size(), num_data );
+    TEST_EQUALITY( reinterpret_cast<const char*>(aligned_view.getRawPtr()),
+		   serializer.begin() + sizeof(std::size_t) );
+    TEST_ASSERT( std::equal(aligned_view.begin(), aligned_view.end(), 
+			    data.begin()) );
+
+    char ds_char = 'b';
+    deserializer >> ds_char;
+    TEST_EQUALITY( ds_char, data_char );
+
+    // The misaligned array is copied.
+    Teuchos::ArrayRCP<const double> copied_view = deserializer.view<double>();
+    TEST_EQUALITY( copied_view.size(), num_data );
+    TEST_ASSERT( 
+	reinterpret_cast<const char*>(copied_view.getRawPtr()) < 
+	deserializer.begin() ||
+	reinterpret_cast<const char*>(copied_view.getRawPtr()) >= 
+	deserializer.end() );
+    TEST_ASSERT( std::equal(copied_view.begin(), copied_view.end(), 
+			    data.begin()) );
+    TEST_EQUALITY( deserializer.getPtr(), deserializer.end() );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DataSerializer, aligned_pack_unpack_test )
+{
+    int num_data = 10;
+    Teuchos::Array<double> data( num_data );
+    for ( int n = 0; n < num_data; ++n )
+    {
+	data[n] = 1.2 * n;
+    }
+    char data_char = 'a';
+    double data_dbl = 3.2;
+    std::vector<float> empty;
+    std::size_t alignment = 64;
+
+    // Stream layout: char at 0, count at 8, array at 64, char at 144, double
+    // at 152, empty count at 160.
+    std::size_t buffer_size = 160 + sizeof(std::size_t);
+
+    Bricks::DataSerializer serializer;
+    serializer.setAlignment( alignment );
+    serializer.computeBufferSizeMode();
+    serializer << data_char << data << data_char << data_dbl << empty;
+    TEST_EQUALITY( serializer.size(), buffer_size );
+
+    Teuchos::Array<char> buffer( serializer.size() );
+    serializer.setBuffer( buffer() );
+    serializer << data_char << data << data_char << data_dbl << empty;
+    TEST_EQUALITY( serializer.getPtr(), serializer.end() );
+
+    serializer.growableBufferMode();
+    serializer << data_char << data << data_char << data_dbl << empty;
+    TEST_EQUALITY( serializer.size(), buffer_size );
+    TEST_ASSERT( std::equal(buffer.begin(), buffer.end(), 
+			    serializer.begin()) );
+
+    Bricks::DataDeserializer deserializer;
+    deserializer.setAlignment( alignment );
+    deserializer.setBuffer( buffer() );
+
+    char ds_char = 'b';
+    deserializer >> ds_char;
+    TEST_EQUALITY( ds_char, data_char );
+
+    Teuchos::ArrayRCP<const double> ds_view = deserializer.view<double>();
+    TEST_EQUALITY( reinterpret_cast<const char*>(ds_view.getRawPtr()),
+		   deserializer.begin() + alignment );
+    TEST_ASSERT( std::equal(ds_view.begin(), ds_view.end(), data.begin()) );
+
+    ds_char = 'b';
+    deserializer >> ds_char;
+    TEST_EQUALITY( ds_char, data_char );
+
+    double ds_dbl = 0.0;
+    deserializer >> ds_dbl;
+    TEST_EQUALITY( ds_dbl, data_dbl );
+
+    std::vector<float> ds_empty( 1 );
+    deserializer >> ds_empty;
+    TEST_ASSERT( ds_empty.empty() );
+    TEST_EQUALITY( deserializer.getPtr(), deserializer.end() );
+
+    // Unpack the array with a copy.
+    deserializer.setBuffer( buffer() );
+    Teuchos::Array<double> ds_data;
+    deserializer >> ds_char >> ds_data;
+    TEST_EQUALITY( ds_data, data );
+}
+
 //---------------------------------------------------------------------------//
 // end tstDataSerializer.cpp
 //---------------------------------------------------------------------------//